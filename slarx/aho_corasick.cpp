@@ -0,0 +1,178 @@
+#include "aho_corasick.h"
+
+#include <set>
+#include <stdexcept>
+
+namespace slarx
+{
+	const uint32_t AhoCorasickAutomaton::kNoState;
+
+	AhoCorasickAutomaton::AhoCorasickAutomaton(const std::vector<std::string_view>& keywords, bool report_automaton_was_created)
+		: number_of_keywords_(keywords.size()), dfa_(Build(keywords, report_automaton_was_created))
+	{
+	}
+
+	DFA AhoCorasickAutomaton::Build(const std::vector<std::string_view>& keywords, bool report_automaton_was_created)
+	{
+		Alphabet alphabet;
+		for(std::string_view keyword : keywords)
+		{
+			for(char c : keyword)
+			{
+				if(c == kEpsilon)
+					throw std::invalid_argument(std::string("The keywords may not contain '") + kEpsilon + "'.");
+				if(!alphabet.Contains(c))
+				{
+					alphabet.AddCharacter(c);
+				}
+			}
+		}
+		const ByteClasses classes(alphabet, true);
+		const uint32_t number_of_columns = classes.Size();
+
+		// The trie, whose row-major transitions become the transitions of the DFA. State 0 is the root
+		std::vector<uint32_t> transitions(number_of_columns, DFATransitionTable::kNoTransition);
+		std::vector<uint32_t> state_of_keyword;
+		uint32_t number_of_states = 1;
+		for(std::string_view keyword : keywords)
+		{
+			uint32_t state = 0;
+			for(char c : keyword)
+			{
+				uint32_t& next = transitions[ static_cast<size_t>(state) * number_of_columns + classes.Get(c) ];
+				if(next == DFATransitionTable::kNoTransition)
+				{
+					next = number_of_states++;
+					transitions.resize(static_cast<size_t>(number_of_states) * number_of_columns, DFATransitionTable::kNoTransition);
+				}
+				state = transitions[ static_cast<size_t>(state) * number_of_columns + classes.Get(c) ];
+			}
+			state_of_keyword.push_back(state);
+		}
+
+		keyword_offsets_.assign(number_of_states + 2, 0);
+		for(uint32_t state : state_of_keyword)
+		{
+			++keyword_offsets_[ state + 1 ];
+		}
+		for(uint32_t s = 0; s <= number_of_states; ++s)
+		{
+			keyword_offsets_[ s + 1 ] += keyword_offsets_[ s ];
+		}
+		keywords_.resize(state_of_keyword.size());
+		std::vector<uint32_t> next_keyword(keyword_offsets_.begin(), keyword_offsets_.end() - 1);
+		for(uint32_t keyword = 0; keyword < state_of_keyword.size(); ++keyword)
+		{
+			keywords_[ next_keyword[ state_of_keyword[ keyword ] ]++ ] = keyword;
+		}
+		auto has_keywords = [this](uint32_t state) { return keyword_offsets_[ state + 1 ] != keyword_offsets_[ state ]; };
+
+		// Breadth first order visits the failure state of a state (which is shallower) before the state, so its row is
+		// complete and a missing transition is copied from it. The transitions of the trie lead to states, whose failure
+		// state is reached on the same character from the failure state of their parent
+		std::vector<uint32_t> failure(number_of_states, 0);
+		output_links_.assign(number_of_states + 1, kNoState);
+		std::vector<uint32_t> queue;
+		queue.reserve(number_of_states);
+		for(uint32_t k = 1; k < number_of_columns; ++k)
+		{
+			uint32_t& next = transitions[ k ];
+			if(next == DFATransitionTable::kNoTransition)
+			{
+				next = 0;
+			}
+			else
+			{
+				queue.push_back(next);
+			}
+		}
+		for(size_t i = 0; i < queue.size(); ++i)
+		{
+			const uint32_t state = queue[ i ];
+			const uint32_t* failure_row = transitions.data() + static_cast<size_t>(failure[ state ]) * number_of_columns;
+			uint32_t* row = transitions.data() + static_cast<size_t>(state) * number_of_columns;
+			for(uint32_t k = 1; k < number_of_columns; ++k)
+			{
+				if(row[ k ] == DFATransitionTable::kNoTransition)
+				{
+					row[ k ] = failure_row[ k ];
+				}
+				else
+				{
+					failure[ row[ k ] ] = failure_row[ k ];
+					queue.push_back(row[ k ]);
+				}
+			}
+			const uint32_t failure_state = failure[ state ];
+			output_links_[ state ] = has_keywords(failure_state) ? failure_state : output_links_[ failure_state ];
+		}
+
+		std::set<State> accepting_states;
+		DFATransitionTable transition_table(number_of_states, alphabet, classes);
+		std::vector<char> class_representatives = classes.GetRepresentatives();
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			if(has_keywords(s) || output_links_[ s ] != kNoState)
+			{
+				accepting_states.insert(State(s));
+			}
+			for(char c : class_representatives)
+			{
+				transition_table.AddTransition(State(s), c, State(transitions[ static_cast<size_t>(s) * number_of_columns + classes.Get(c) ]));
+			}
+		}
+
+		State start_state = State(0);
+		return DFA(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states),
+				   std::move(transition_table), report_automaton_was_created);
+	}
+
+	std::vector<uint32_t> AhoCorasickAutomaton::GetKeywords(uint32_t state) const
+	{
+		std::vector<uint32_t> keywords;
+		for(; state != kNoState; state = output_links_[ state ])
+		{
+			keywords.insert(keywords.end(), keywords_.begin() + keyword_offsets_[ state ], keywords_.begin() + keyword_offsets_[ state + 1 ]);
+		}
+		return keywords;
+	}
+
+	bool AhoCorasickAutomaton::ReportKeywords(uint32_t state, size_t end, const std::function<bool(uint32_t, size_t)>& on_match) const
+	{
+		for(; state != kNoState; state = output_links_[ state ])
+		{
+			for(uint32_t k = keyword_offsets_[ state ]; k < keyword_offsets_[ state + 1 ]; ++k)
+			{
+				if(!on_match(keywords_[ k ], end))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void AhoCorasickAutomaton::Scan(const char* data, size_t size, const std::function<bool(uint32_t, size_t)>& on_match) const
+	{
+		const DFATransitionTable& table = dfa_.GetTransitionTable();
+		const ByteClasses& classes = table.GetByteClasses();
+		const uint32_t* transitions = table.GetData();
+		const size_t number_of_columns = table.GetNumberOfColumns();
+		const uint32_t sink_state = table.GetSinkState();
+		const uint32_t start_state = dfa_.GetStartState().GetValue();
+		const uint8_t* accepting_lookup = dfa_.GetAcceptingLookup().data();
+
+		uint32_t state = start_state;
+		// Only the empty keyword ends in the start state
+		if(accepting_lookup[ state ] && !ReportKeywords(state, 0, on_match))
+			return;
+		for(size_t i = 0; i < size; ++i)
+		{
+			state = transitions[ state * number_of_columns + classes.Get(data[ i ]) ];
+			if(state == sink_state)
+			{
+				state = start_state;
+			}
+			if(accepting_lookup[ state ] && !ReportKeywords(state, i + 1, on_match))
+				return;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef SLARX_AHO_CORASICK_H_INCLUDED
+#define SLARX_AHO_CORASICK_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "dfa.h"
+#include <functional>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace slarx
+{
+	// The Aho-Corasick automaton of a set of keywords, which finds all of their occurrences in a single pass over a text. The
+	// keywords form a trie, whose state for a prefix fails over to the state for its longest proper suffix in the trie. The
+	// failure links are resolved while the trie is traversed in breadth first order, so every state gets a transition on every
+	// character of the keywords and the result is a DFA for the words, which end with a keyword. A state matches the keywords,
+	// which are suffixes of its prefix. They are stored once per state, together with a link to the nearest state on the failure
+	// chain, which matches keywords too, so that nested keywords do not make the automaton quadratic in size
+	class AhoCorasickAutomaton
+	{
+	public:
+		static const uint32_t kNoState = UINT32_MAX;
+
+		// The ID of a keyword is its index in keywords. Throws std::invalid_argument if a keyword contains kEpsilon
+		explicit AhoCorasickAutomaton(const std::vector<std::string_view>& keywords, bool report_automaton_was_created = false);
+
+		// Returns the search DFA, whose alphabet holds the characters of the keywords and whose accepting states match keywords
+		const DFA& GetDFA() const { return dfa_; }
+		// Moves the search DFA out of the automaton, which can not be used afterwards
+		DFA ReleaseDFA() { return DFA(std::move(dfa_), false); }
+		// Returns the IDs of the keywords, which end in a state of the DFA
+		std::vector<uint32_t> GetKeywords(uint32_t state) const;
+		size_t GetNumberOfKeywords() const { return number_of_keywords_; }
+
+		// Calls on_match(keyword, end) for every occurrence of a keyword, which ends at end, in order of end. A character outside
+		// of the alphabet ends every occurrence, so the scan starts over from the start state after it. Stops when on_match returns false
+		void Scan(const char* data, size_t size, const std::function<bool(uint32_t keyword, size_t end)>& on_match) const;
+
+	private:
+		// Builds the search DFA and fills in the keywords of its states. Called by the constructor before dfa_ is initialized
+		DFA Build(const std::vector<std::string_view>& keywords, bool report_automaton_was_created);
+		// Reports the keywords of state. Returns false if on_match asked to stop
+		bool ReportKeywords(uint32_t state, size_t end, const std::function<bool(uint32_t, size_t)>& on_match) const;
+
+		size_t number_of_keywords_;
+		// The keywords equal to the prefix of state s are keywords_[ keyword_offsets_[ s ] ] to keywords_[ keyword_offsets_[ s + 1 ] - 1 ].
+		// Has entries for the sink row, which has no keywords
+		std::vector<uint32_t> keyword_offsets_;
+		std::vector<uint32_t> keywords_;
+		// The nearest state on the failure chain of a state, which has keywords, or kNoState
+		std::vector<uint32_t> output_links_;
+		DFA dfa_;
+	};
+}
+
+#endif // SLARX_AHO_CORASICK_H_INCLUDED
@@ -3,15 +3,71 @@
 #include "automata_set_operations.h"
 #include "utility.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace slarx
 {
+	namespace
+	{
+		// Builds the product of a and b. A pair of states is accepting if accept(a accepts, b accepts) is true. A character
+		// outside of an operand's alphabet sends it to the sink row of its transition table, which is a rejecting trap
+		template<typename Operation>
+		DFA AutomataProduct(const DFA& a, const DFA& b, Operation accept, bool report_automaton_was_created)
+		{
+			const DFATransitionTable& a_table = a.GetTransitionTable();
+			const DFATransitionTable& b_table = b.GetTransitionTable();
+			Alphabet product_alphabet = AlphabetUnion(a.GetAlphabet(), b.GetAlphabet());
+			// Two characters behave the same in the product only if they behave the same in both operands
+			ByteClasses product_classes(product_alphabet, false);
+			product_classes.Refine(a_table.GetByteClasses());
+			product_classes.Refine(b_table.GetByteClasses());
+			std::vector<char> class_representatives = product_classes.GetRepresentatives();
+
+			// Product state i is the pair pairs[ i ], which is keyed in pair_index as (a state << 32) | b state
+			std::vector<std::pair<uint32_t, uint32_t> > pairs;
+			std::unordered_map<uint64_t, uint32_t> pair_index;
+			std::set<State> product_accepting_states;
+			DFATransitionTable product_transition_table(0, product_alphabet, product_classes);
+			auto find_or_add_pair = [&](uint32_t p, uint32_t q) -> State
+			{
+				auto inserted = pair_index.insert(std::make_pair((static_cast<uint64_t>(p) << 32) | q, static_cast<uint32_t>(pairs.size())));
+				if(inserted.second)
+				{
+					if(accept(a.GetAcceptingLookup()[ p ] != 0, b.GetAcceptingLookup()[ q ] != 0))
+					{
+						product_accepting_states.insert(State(inserted.first->second));
+					}
+					pairs.push_back(std::make_pair(p, q));
+					product_transition_table.SetNumberOfStates(pairs.size());
+				}
+				return State(inserted.first->second);
+			};
+
+			State product_start_state = find_or_add_pair(a.GetStartState().GetValue(), b.GetStartState().GetValue());
+			for(uint32_t i = 0; i < pairs.size(); ++i)
+			{
+				for(char c : class_representatives)
+				{
+					State to = find_or_add_pair(a_table.GetClassTransition(pairs[ i ].first, a_table.GetColumn(c)),
+												b_table.GetClassTransition(pairs[ i ].second, b_table.GetColumn(c)));
+					product_transition_table.AddTransition(State(i), c, to);
+				}
+			}
+
+			uint32_t product_number_of_states = pairs.size();
+			return DFA(std::move(product_number_of_states), std::move(product_alphabet), std::move(product_start_state),
+					   std::move(product_accepting_states), std::move(product_transition_table), report_automaton_was_created);
+		}
+	}
+
 	// Creates an epsilon NFA of the union of two conversion NFA's
 	// Constructs it by adding a new start state and adding two
 	// epsilon transitions from it to a's start state and from it to
 	// b's start state
-	DFA AutomataUnion(const DFA& a, const DFA& b)
+	DFA AutomataUnion(const DFA& a, const DFA& b, bool report_automaton_was_created)
 	{
-		return AutomataUnion(ConversionNFA(a), ConversionNFA(b)).ToDFA();
+		return AutomataUnion(ConversionNFA(a), ConversionNFA(b)).ToDFA(report_automaton_was_created);
 	}
 
 	ConversionNFA AutomataUnion(const ConversionNFA& a, const ConversionNFA& b)
@@ -45,12 +101,11 @@ namespace slarx
 		const ConversionNFATransitionTable& input_transition_table = input_nfa.GetTransitionTable();
 		for(int i = 0; i < input_transition_table.GetTransitions().size(); ++i)
 		{
-			for(char c : input_nfa.GetAlphabet().GetCharacters())
+			for(const auto& on_to : input_transition_table.GetTransitions()[ i ])
 			{
-				auto transition = input_transition_table.GetTransition(State(i), c);
-				for(State to : transition)
+				for(State to : on_to.second)
 				{
-					result_transition_table.AddTransition(State(i + offset), c, State(to.GetValue() + offset));
+					result_transition_table.AddTransition(State(i + offset), on_to.first, State(to.GetValue() + offset));
 				}
 			}
 		}
@@ -78,9 +133,9 @@ namespace slarx
 		return ConversionNFA(result_nfa_number_of_states, result_nfa_alphabet, result_nfa_start_state, result_nfa_accepting_states, result_nfa_transition_table);
 	}
 
-	DFA AutomataConcatenation(const DFA& a, const DFA& b)
+	DFA AutomataConcatenation(const DFA& a, const DFA& b, bool report_automaton_was_created)
 	{
-		return AutomataConcatenation(ConversionNFA(a), ConversionNFA(b)).ToDFA();
+		return AutomataConcatenation(ConversionNFA(a), ConversionNFA(b)).ToDFA(report_automaton_was_created);
 	}
 
 	ConversionNFA AutomataKleenyStar(const ConversionNFA& a)
@@ -102,11 +157,31 @@ namespace slarx
 
 		return ConversionNFA(result_nfa_number_of_states, result_nfa_alphabet, result_nfa_start_state, result_nfa_accepting_states, result_nfa_transition_table);
 	}
-	DFA AutomataKleenyStar(const DFA& a)
+	DFA AutomataKleenyStar(const DFA& a, bool report_automaton_was_created)
+	{
+		return AutomataKleenyStar(ConversionNFA(a)).ToDFA(report_automaton_was_created);
+	}
+
+
+	DFA AutomataIntersection(const DFA& a, const DFA& b, bool report_automaton_was_created)
+	{
+		return AutomataProduct(a, b, [](bool in_a, bool in_b) { return in_a && in_b; }, report_automaton_was_created);
+	}
+
+	DFA AutomataDifference(const DFA& a, const DFA& b, bool report_automaton_was_created)
 	{
-		return AutomataKleenyStar(ConversionNFA(a)).ToDFA();
+		return AutomataProduct(a, b, [](bool in_a, bool in_b) { return in_a && !in_b; }, report_automaton_was_created);
 	}
 
+	DFA AutomataSymmetricDifference(const DFA& a, const DFA& b, bool report_automaton_was_created)
+	{
+		return AutomataProduct(a, b, [](bool in_a, bool in_b) { return in_a != in_b; }, report_automaton_was_created);
+	}
+
+	DFA AutomataProductUnion(const DFA& a, const DFA& b, bool report_automaton_was_created)
+	{
+		return AutomataProduct(a, b, [](bool in_a, bool in_b) { return in_a || in_b; }, report_automaton_was_created);
+	}
 
 	Alphabet AlphabetUnion(const Alphabet& a, const Alphabet& b)
 	{
@@ -8,12 +8,20 @@
 namespace slarx
 {
 	ConversionNFA AutomataUnion(const ConversionNFA& a, const ConversionNFA& b);
-	DFA AutomataUnion(const DFA& a, const DFA& b);
+	// The DFA operations report the creation of their result unless report_automaton_was_created is false
+	DFA AutomataUnion(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
 	void AddInitialTransitionsToNewTransitionTable(ConversionNFATransitionTable& result_transition_table, const ConversionNFA& input_nfa, uint32_t offset);
 	ConversionNFA AutomataConcatenation(const ConversionNFA& a, const ConversionNFA& b);
-	DFA AutomataConcatenation(const DFA& a, const DFA& b);
+	DFA AutomataConcatenation(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
 	ConversionNFA AutomataKleenyStar(const ConversionNFA& a);
-	DFA AutomataKleenyStar(const DFA& a);
+	DFA AutomataKleenyStar(const DFA& a, bool report_automaton_was_created = true);
+
+	// Product constructions. They run both DFAs in parallel over the union of their alphabets and only create the
+	// reachable pairs of states, so the result has at most (|a| + 1) * (|b| + 1) states and needs no determinization
+	DFA AutomataIntersection(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
+	DFA AutomataDifference(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
+	DFA AutomataSymmetricDifference(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
+	DFA AutomataProductUnion(const DFA& a, const DFA& b, bool report_automaton_was_created = true);
 
 	Alphabet AlphabetUnion(const Alphabet& a, const Alphabet& b);
 }
@@ -7,6 +7,10 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <stdexcept>
 
 namespace slarx
 {
@@ -22,57 +26,152 @@ namespace slarx
 		return Alphabet(SetUnion<char>(a.GetCharacters(), b.GetCharacters()));
 	}
 
-	void ReadAutomatonData(std::ifstream& input_file, uint32_t& number_of_states, Alphabet& alphabet, State& start_state, std::set<State>& accepting_states)
+	bool AutomatonTextParser::NextLine(const char*& begin, const char*& end)
 	{
-		std::string line;
-		getline(input_file, line); // Discard automaton type specifier
+		if(position_ == end_)
+			return false;
 
-		std::vector<int> integers;
-		for(int i = 1; i <= 4; ++i)
+		begin = position_;
+		const char* new_line = static_cast<const char*>(std::memchr(position_, '\n', end_ - position_));
+		end = (new_line != nullptr) ? new_line : end_;
+		position_ = (new_line != nullptr) ? new_line + 1 : end_;
+		if(end != begin && *(end - 1) == '\r')
+			--end;
+		return true;
+	}
+
+	std::vector<uint32_t> AutomatonTextParser::ParseIntegerLine(const char* begin, const char* end) const
+	{
+		std::vector<uint32_t> integers;
+		while(begin != end)
+		{
+			if(*begin == ' ' || *begin == '\t')
+			{
+				++begin;
+				continue;
+			}
+			uint32_t x;
+			auto result = std::from_chars(begin, end, x);
+			if(result.ec != std::errc())
+			{
+				throw std::invalid_argument("Failed to parse string of integers - noninteger character(s) detected.");
+			}
+			integers.push_back(x);
+			begin = result.ptr;
+		}
+		return integers;
+	}
+
+	std::string AutomatonTextParser::ReadType()
+	{
+		const char* begin = position_;
+		const char* end = position_;
+		NextLine(begin, end);
+		++line_number_;
+		return std::string(begin, end);
+	}
+
+	void AutomatonTextParser::ReadAutomatonData(uint32_t& number_of_states, Alphabet& alphabet, State& start_state, std::set<State>& accepting_states)
+	{
+		// Missing lines are treated as empty ones
+		const char* begin = position_;
+		const char* end = position_;
+		auto next_header_line = [&]()
+		{
+			begin = end = position_;
+			NextLine(begin, end);
+			++line_number_;
+		};
+
+		next_header_line();
+		std::vector<uint32_t> integers = ParseIntegerLine(begin, end);
+		if(integers.size() != 1)
 		{
-			getline(input_file, line);
-			switch(i)
+			throw std::invalid_argument("The second row specifies an invalid number of states.");
+		}
+		number_of_states = integers[ 0 ];
+
+		next_header_line();
+		for(; begin != end; ++begin)
+		{
+			if(!std::isspace(static_cast<unsigned char>(*begin)))
 			{
-				// TODO - Reformat this...
-				case 1:
-					integers = IntegerParse(line);
-					if(integers.size() != 1)
-					{
-						integers.clear();
-						throw std::invalid_argument("The second row specifies an invalid number of states.");
-					}
-					else
-					{
-						number_of_states = integers[ 0 ];
-						integers.clear();
-					}
-					break;
-				case 2:
-					alphabet.ReadAlphabet(line);
-					break;
-				case 3:
-					integers = IntegerParse(line);
-					if(integers.size() != 1)
-					{
-						integers.clear();
-						throw std::invalid_argument("The fourth row specifies an invalid number for a start state.");
-					}
-					else
-					{
-						start_state = State(integers[ 0 ]);
-						integers.clear();
-					}
-					break;
-				case 4:
-					integers = IntegerParse(line);
-					for(auto number : integers)
-					{
-						accepting_states.insert(State(number));
-					}
-					integers.clear();
-					break;
+				alphabet.AddCharacter(*begin);
 			}
 		}
+
+		next_header_line();
+		integers = ParseIntegerLine(begin, end);
+		if(integers.size() != 1)
+		{
+			throw std::invalid_argument("The fourth row specifies an invalid number for a start state.");
+		}
+		if(integers[ 0 ] >= number_of_states)
+		{
+			std::stringstream error_message;
+			error_message << "Line " << line_number_ - 1 << " (start state) - the start state is an unexisting state!";
+			throw std::invalid_argument(error_message.str());
+		}
+		start_state = State(integers[ 0 ]);
+
+		next_header_line();
+		for(uint32_t number : ParseIntegerLine(begin, end))
+		{
+			if(number >= number_of_states)
+			{
+				std::stringstream error_message;
+				error_message << "Line " << line_number_ - 1 << " (accepting states) - accepting state " << number << " is an unexisting state!";
+				throw std::invalid_argument(error_message.str());
+			}
+			accepting_states.insert(State(number));
+		}
+	}
+
+	bool AutomatonTextParser::ReadTransition(uint32_t& from, char& on, uint32_t& to)
+	{
+		const char* begin;
+		const char* end;
+		if(!NextLine(begin, end))
+			return false;
+
+		// Tokens are separated by single spaces. A single trailing space is allowed
+		const char* first_space = static_cast<const char*>(std::memchr(begin, ' ', end - begin));
+		const char* second_space = (first_space != nullptr) ? static_cast<const char*>(std::memchr(first_space + 1, ' ', end - first_space - 1)) : nullptr;
+		const char* to_end = (second_space != nullptr) ? static_cast<const char*>(std::memchr(second_space + 1, ' ', end - second_space - 1)) : nullptr;
+		if(second_space == nullptr || (to_end != nullptr && to_end + 1 != end))
+		{
+			ThrowTransitionError("contains too many or too few arguments! (should be 3)");
+		}
+		if(to_end == nullptr)
+		{
+			to_end = end;
+		}
+
+		auto parse_state = [this](const char* token_begin, const char* token_end, uint32_t& state)
+		{
+			auto result = std::from_chars(token_begin, token_end, state);
+			if(result.ec != std::errc() || std::find_if(result.ptr, token_end, [](char c) { return c != '\t'; }) != token_end)
+			{
+				ThrowTransitionError("contains an invalid state number!");
+			}
+		};
+		parse_state(begin, first_space, from);
+		parse_state(second_space + 1, to_end, to);
+		if(second_space - first_space != 2)
+		{
+			ThrowTransitionError("should contain a single character between the states!");
+		}
+		on = first_space[ 1 ];
+
+		++line_number_;
+		return true;
+	}
+
+	void AutomatonTextParser::ThrowTransitionError(const std::string& problem) const
+	{
+		std::stringstream error_message;
+		error_message << "Line " << line_number_ << " (transition of " << automaton_kind_ << ") " << problem;
+		throw std::invalid_argument(error_message.str());
 	}
 
 	Identifier Automaton::CreateIdentifier()
@@ -87,7 +186,7 @@ namespace slarx
 		char input_char;
 		while(input_stream >> input_char)
 		{
-			characters_.insert(input_char);
+			AddCharacter(input_char);
 		}
 		return true;
 	}
@@ -108,6 +207,41 @@ namespace slarx
 	{
 		using std::swap;
 		swap(a.characters_, b.characters_);
+		swap(a.members_, b.members_);
+	}
+
+	ByteClasses::ByteClasses(const Alphabet& alphabet, bool split_characters) : number_of_classes_(1)
+	{
+		classes_.fill(0);
+		for(char c : alphabet.GetCharacters())
+		{
+			classes_[ static_cast<unsigned char>(c) ] = split_characters ? number_of_classes_++ : 1;
+		}
+		if(!split_characters && alphabet.Size() > 0)
+		{
+			number_of_classes_ = 2;
+		}
+	}
+
+	ByteClasses::ByteClasses(const std::array<Class, 256>& classes) : classes_(classes)
+	{
+		number_of_classes_ = *std::max_element(classes_.begin(), classes_.end()) + 1;
+	}
+
+	std::vector<char> ByteClasses::GetRepresentatives() const
+	{
+		std::vector<char> representatives(number_of_classes_ - 1);
+		std::vector<bool> found(number_of_classes_, false);
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			Class k = classes_[ c ];
+			if(k != 0 && !found[ k ])
+			{
+				found[ k ] = true;
+				representatives[ k - 1 ] = static_cast<char>(c);
+			}
+		}
+		return representatives;
 	}
 
 	void swap(Automaton & a, Automaton & b) noexcept
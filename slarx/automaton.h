@@ -8,6 +8,10 @@
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
 
 namespace slarx
 {
@@ -56,26 +60,82 @@ namespace slarx
 	{
 	public:
 		Alphabet() = default;
-		Alphabet(const std::set<char>& characters) : characters_(characters) { }
+		Alphabet(const std::set<char>& characters) : characters_(characters) { for(char c : characters_) members_.set(static_cast<unsigned char>(c)); }
 		Alphabet(const std::string& alphabet) { ReadAlphabet(alphabet); }
-		Alphabet(const Alphabet& other) : characters_(other.characters_) { }
+		Alphabet(const Alphabet& other) : characters_(other.characters_), members_(other.members_) { }
 		Alphabet& operator=(Alphabet other) { swap(*this, other); return *this; }
 		~Alphabet() = default;
 
 		bool ReadAlphabet(const std::string& source);
-		bool Contains(char c) const { return std::find(characters_.begin(), characters_.end(), c) != characters_.end(); }
-		size_t Size(){ return characters_.size(); }
+		bool Contains(char c) const { return members_.test(static_cast<unsigned char>(c)); }
+		size_t Size() const { return characters_.size(); }
 		const std::set<char>& GetCharacters() const { return characters_; }
-		void AddCharacter(char c){ characters_.insert(c); }
-		void RemoveCharacter(char c){ characters_.erase(c); }
+		void AddCharacter(char c){ characters_.insert(c); members_.set(static_cast<unsigned char>(c)); }
+		void RemoveCharacter(char c){ characters_.erase(c); members_.reset(static_cast<unsigned char>(c)); }
 
 		friend void swap(Alphabet& a, Alphabet& b) noexcept;
 	private:
 		std::set<char> characters_;
+		// Membership bit for every byte, so that Contains is a single lookup
+		std::bitset<256> members_;
 		// Used only for debugging purposes
 		void Debug_PrintAlphabet(std::ostream& out){ for(auto i : characters_ ) out << i << ' '; }
 	};
 
+	// Maps every byte to a class of characters. Class 0 holds the characters outside of the alphabet
+	// and characters, which behave the same way in an automaton, share a class. Transition tables
+	// have one column per class, so their width depends on the number of distinct behaviours
+	class ByteClasses
+	{
+	public:
+		typedef uint16_t Class;
+		ByteClasses() : number_of_classes_(1) { classes_.fill(0); }
+		// Puts every character of the alphabet in class 1 (or in its own class if split_characters is true)
+		ByteClasses(const Alphabet& alphabet, bool split_characters);
+		// Uses an existing byte to class map. Classes must be numbered 0, 1, 2, ... without gaps
+		explicit ByteClasses(const std::array<Class, 256>& classes);
+		ByteClasses(const ByteClasses& other) = default;
+		ByteClasses& operator=(const ByteClasses& other) = default;
+		~ByteClasses() = default;
+
+		Class Get(char c) const { return classes_[ static_cast<unsigned char>(c) ]; }
+		// Number of classes, including class 0
+		uint32_t Size() const { return number_of_classes_; }
+		const std::array<Class, 256>& GetClasses() const { return classes_; }
+		// Returns one character of every class, where the character at index k - 1 belongs to class k
+		std::vector<char> GetRepresentatives() const;
+		// Splits the classes, so that two characters stay in the same class only if key returns the same value for both.
+		// Key is called as key(unsigned char) and should return an integer. Class 0 is never split
+		template<typename Key>
+		void Refine(Key key);
+		// Splits the classes, so that two characters stay in the same class only if they share a class in other too
+		void Refine(const ByteClasses& other) { Refine([&other](unsigned char c) -> uint32_t { return other.classes_[ c ]; }); }
+
+	private:
+		std::array<Class, 256> classes_;
+		uint32_t number_of_classes_;
+	};
+
+	template<typename Key>
+	void ByteClasses::Refine(Key key)
+	{
+		// Classes are renumbered in order of their smallest character, so the result does not depend on the previous numbering
+		std::unordered_map<uint64_t, Class> new_class_of;
+		uint32_t new_number_of_classes = 1;
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			if(classes_[ c ] == 0)
+				continue;
+
+			uint64_t signature = (static_cast<uint64_t>(classes_[ c ]) << 32) | static_cast<uint32_t>(key(static_cast<unsigned char>(c)));
+			auto inserted = new_class_of.insert(std::make_pair(signature, static_cast<Class>(new_number_of_classes)));
+			if(inserted.second)
+				++new_number_of_classes;
+			classes_[ c ] = inserted.first->second;
+		}
+		number_of_classes_ = new_number_of_classes;
+	}
+
 	// Merges the characters of two alphabets, returning the result (Set union)
 	Alphabet MergeAlphabets(const Alphabet& a, const Alphabet& b);
 
@@ -93,7 +153,7 @@ namespace slarx
 											accepting_states_(other.accepting_states_)  { }
 		Automaton(uint32_t&& number_of_states, Alphabet&& alphabet, 
 				  State&& start_state, std::set<State>&& accepting_states) : id_(CreateIdentifier()), number_of_states_(number_of_states),
-																			alphabet_(alphabet), start_state_(start_state), accepting_states_(accepting_states) { }
+																			alphabet_(std::move(alphabet)), start_state_(start_state), accepting_states_(std::move(accepting_states)) { }
 		virtual ~Automaton() { }
 		
 		// Reads information for an Automaton from the file located at path 
@@ -140,8 +200,39 @@ namespace slarx
 		std::set<State> accepting_states_;
 	};
 
-	// Reads data, which is common for all automata (reads first 5 lines of file)
-	void ReadAutomatonData(std::ifstream& input_file, uint32_t& number_of_states, Alphabet& alphabet, State& start_state, std::set<State>& accepting_states);
+	// Single pass parser for the text automaton format (see Tests/test_format.txt). Works in place on a buffer
+	// holding the whole file (usually a MappedFile) and parses numbers with std::from_chars, so reading a
+	// transition allocates nothing. Errors are reported as std::invalid_argument with the number of the line
+	class AutomatonTextParser
+	{
+	public:
+		// automaton_kind is used in error messages (e.g. "DFA")
+		AutomatonTextParser(const char* data, size_t size, const std::string& automaton_kind) 
+			: position_(data), end_(data + size), line_number_(0), automaton_kind_(automaton_kind) { }
+
+		// Reads the automaton type specifier (first line of file)
+		std::string ReadType();
+		// Reads data, which is common for all automata (the 4 lines after the type specifier)
+		void ReadAutomatonData(uint32_t& number_of_states, Alphabet& alphabet, State& start_state, std::set<State>& accepting_states);
+		// Reads the next transition line in the format <from> <on> <to>. Returns false if there are no more lines.
+		// Does not check the states against the number of states
+		bool ReadTransition(uint32_t& from, char& on, uint32_t& to);
+		// Index of the next line to be read, counting the type specifier as line 0
+		int GetLineNumber() const { return line_number_; }
+		void SetAutomatonKind(const std::string& automaton_kind) { automaton_kind_ = automaton_kind; }
+
+	private:
+		// Sets [begin, end) to the next line without its line ending. Returns false at the end of the buffer
+		bool NextLine(const char*& begin, const char*& end);
+		// Parses a line of blank separated unsigned integers
+		std::vector<uint32_t> ParseIntegerLine(const char* begin, const char* end) const;
+		[[noreturn]] void ThrowTransitionError(const std::string& problem) const;
+
+		const char* position_;
+		const char* end_;
+		int line_number_;
+		std::string automaton_kind_;
+	};
 }
 
 
@@ -0,0 +1,129 @@
+#include "bit_parallel_nfa.h"
+
+#include <stdexcept>
+#include <sstream>
+
+namespace slarx
+{
+	const uint32_t BitParallelNFA::kMaxStates;
+	const uint32_t BitParallelNFA::kStatesPerGroup;
+	const uint32_t BitParallelNFA::kSubsetsPerGroup;
+
+	BitParallelNFA::BitParallelNFA(const ConversionNFA& nfa) : alphabet_(nfa.GetAlphabet())
+	{
+		if(nfa.Size() > kMaxStates)
+		{
+			std::stringstream error_message;
+			error_message << "Bit-parallel simulation supports at most " << kMaxStates << " states, but the automaton has " << nfa.Size() << "!";
+			throw(std::invalid_argument(error_message.str()));
+		}
+
+		alphabet_.RemoveCharacter(kEpsilon);
+		classes_ = nfa.GetTransitionTable().ComputeByteClasses(alphabet_);
+		std::vector<char> class_representatives = classes_.GetRepresentatives();
+		EpsilonClosureTable epsilon_closures(nfa.GetTransitionTable(), nfa.Size());
+		// Rows are padded to a power of two words, so that Run can be instantiated for 1, 2 and 4 words only
+		number_of_words_ = 1;
+		while(number_of_words_ < epsilon_closures.GetNumberOfWords())
+		{
+			number_of_words_ *= 2;
+		}
+		number_of_groups_ = (nfa.Size() + kStatesPerGroup - 1) / kStatesPerGroup;
+
+		// The successors of a subset are the union of the successors of its states, so every subset is
+		// built from a smaller one. Class 0 (characters outside of the alphabet) has no successors
+		const size_t class_size = static_cast<size_t>(number_of_groups_) * kSubsetsPerGroup * number_of_words_;
+		successors_.assign(classes_.Size() * class_size, 0);
+		for(size_t k = 1; k < classes_.Size(); ++k)
+		{
+			for(uint32_t g = 0; g < number_of_groups_; ++g)
+			{
+				uint64_t* group_successors = &successors_[ k * class_size + static_cast<size_t>(g) * kSubsetsPerGroup * number_of_words_ ];
+				for(uint32_t v = 1; v < kSubsetsPerGroup; ++v)
+				{
+					uint64_t* subset_successors = group_successors + v * number_of_words_;
+					const uint32_t lowest = CountTrailingZeros(v);
+					const uint32_t state = g * kStatesPerGroup + lowest;
+					if(v != (1u << lowest))
+					{
+						const uint64_t* rest = group_successors + (v & (v - 1)) * number_of_words_;
+						for(uint32_t w = 0; w < number_of_words_; ++w)
+						{
+							subset_successors[ w ] = rest[ w ];
+						}
+					}
+					if(state < nfa.Size())
+					{
+						for(State to : nfa.GetTransitionTable().GetTransition(State(state), class_representatives[ k - 1 ]))
+						{
+							epsilon_closures.AddClosure(to.GetValue(), subset_successors);
+						}
+					}
+				}
+			}
+		}
+
+		start_set_.assign(number_of_words_, 0);
+		epsilon_closures.AddClosure(nfa.GetStartState().GetValue(), start_set_.data());
+		accepting_states_.assign(number_of_words_, 0);
+		for(State s : nfa.GetAcceptingStates())
+		{
+			accepting_states_[ s.GetValue() / 64 ] |= uint64_t(1) << (s.GetValue() % 64);
+		}
+	}
+
+	bool BitParallelNFA::Recognize(const char* data, size_t size) const
+	{
+		switch(number_of_words_)
+		{
+			case 1:
+				return Run<1>(data, size);
+			case 2:
+				return Run<2>(data, size);
+			default:
+				return Run<4>(data, size);
+		}
+	}
+
+	template<uint32_t Words>
+	bool BitParallelNFA::Run(const char* data, size_t size) const
+	{
+		const size_t class_size = static_cast<size_t>(number_of_groups_) * kSubsetsPerGroup * Words;
+		uint64_t current[ Words ];
+		for(uint32_t w = 0; w < Words; ++w)
+		{
+			current[ w ] = start_set_[ w ];
+		}
+
+		for(const char* end = data + size; data != end; ++data)
+		{
+			const uint64_t* class_successors = &successors_[ classes_.Get(*data) * class_size ];
+			uint64_t next[ Words ] = { };
+			for(uint32_t g = 0; g < number_of_groups_; ++g)
+			{
+				const uint32_t subset = (current[ g / 16 ] >> (g % 16 * kStatesPerGroup)) & (kSubsetsPerGroup - 1);
+				const uint64_t* subset_successors = class_successors + (static_cast<size_t>(g) * kSubsetsPerGroup + subset) * Words;
+				for(uint32_t w = 0; w < Words; ++w)
+				{
+					next[ w ] |= subset_successors[ w ];
+				}
+			}
+
+			uint64_t any = 0;
+			for(uint32_t w = 0; w < Words; ++w)
+			{
+				current[ w ] = next[ w ];
+				any |= next[ w ];
+			}
+			if(any == 0)
+				return false;
+		}
+
+		for(uint32_t w = 0; w < Words; ++w)
+		{
+			if(current[ w ] & accepting_states_[ w ])
+				return true;
+		}
+		return false;
+	}
+}
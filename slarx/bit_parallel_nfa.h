@@ -0,0 +1,50 @@
+#pragma once
+#ifndef SLARX_BIT_PARALLEL_NFA_H_INCLUDED
+#define SLARX_BIT_PARALLEL_NFA_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace slarx
+{
+	// Simulates a ConversionNFA with at most kMaxStates states directly, keeping the set of active states in one to
+	// four 64-bit words. The epsilon closed successors of every group of four states on every class of characters
+	// are precomputed for all 16 subsets of the group, so a character costs one table lookup and OR per group.
+	// Nothing is determinized, which makes it the cheapest engine for small automata, which are used only a few times
+	class BitParallelNFA
+	{
+	public:
+		static const uint32_t kMaxStates = 256;
+
+		// Throws std::invalid_argument if the NFA has more than kMaxStates states
+		explicit BitParallelNFA(const ConversionNFA& nfa);
+
+		// Returns true if word is in the language of the NFA and false otherwise
+		bool Recognize(std::string& word) const { return Recognize(word.data(), word.size()); }
+		bool Recognize(const char* data, size_t size) const;
+
+		const Alphabet& GetAlphabet() const { return alphabet_; }
+
+	private:
+		static const uint32_t kStatesPerGroup = 4;
+		static const uint32_t kSubsetsPerGroup = 1 << kStatesPerGroup;
+
+		template<uint32_t Words>
+		bool Run(const char* data, size_t size) const;
+
+		Alphabet alphabet_;
+		ByteClasses classes_;
+		// 1, 2 or 4
+		uint32_t number_of_words_;
+		uint32_t number_of_groups_;
+		// The successors of subset v of group g on class k are the number_of_words_ words starting at
+		// successors_[ ((k * number_of_groups_ + g) * kSubsetsPerGroup + v) * number_of_words_ ]
+		std::vector<uint64_t> successors_;
+		std::vector<uint64_t> start_set_;
+		std::vector<uint64_t> accepting_states_;
+	};
+}
+
+#endif // SLARX_BIT_PARALLEL_NFA_H_INCLUDED
@@ -3,12 +3,90 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <fstream>
+#include <bitset>
+#include <cstring>
 #include "utility.h"
 #include "automata_set_operations.h"
+#include "dfa_minimization.h"
+#include "nfa_recognizer.h"
+#include "parallel_recognition.h"
+#include "dfa_search.h"
+#include "multi_pattern.h"
+#include "dfa_stream_matcher.h"
+#include "regex.h"
+#include "dictionary_dfa.h"
+#include "aho_corasick.h"
+#include "suffix_automaton.h"
 
 namespace slarx
 {
 	using std::cout; using std::endl;
+
+	namespace
+	{
+		// Set by the automin command. If true, the results of set operations are minimized before they are stored
+		bool minimize_operation_results = false;
+
+		// Returns whether a set operation should report the creation of its result. With automatic minimization on, only the
+		// minimized automaton, which is stored, is announced
+		bool ReportOperationResult()
+		{
+			return !minimize_operation_results;
+		}
+
+		// Allocates the result of a set operation, minimizing it first if automatic minimization is turned on
+		DFA* StoreOperationResult(DFA&& result)
+		{
+			if(minimize_operation_results)
+			{
+				return new DFA(MinimizeDFA(result));
+			}
+			return new DFA(std::move(result), false);
+		}
+
+		bool HasBinaryFileExtension(const std::string& file_path)
+		{
+			return file_path.size() > kBinaryFileExtension.size() &&
+				   file_path.compare(file_path.size() - kBinaryFileExtension.size(), kBinaryFileExtension.size(), kBinaryFileExtension) == 0;
+		}
+
+		// Shared implementation of the commands, which combine two active automata with a product construction
+		bool ProductCommand(const std::string& command, std::set<DFA*>& active_automata, DFA (*operation)(const DFA&, const DFA&, bool), const std::string& operation_name)
+		{
+			std::stringstream s(command);
+			std::string text;
+			s >> text; s >> text;
+			uint32_t id1;
+			uint32_t id2;
+			try
+			{
+				id1 = IntegerParse(text)[ 0 ];
+				s >> text;
+				id2 = IntegerParse(text)[ 0 ];
+			}
+			catch(std::invalid_argument)
+			{
+				return false;
+			}
+			const DFA* d1 = GetAutomatonByID(id1, active_automata);
+			const DFA* d2 = GetAutomatonByID(id2, active_automata);
+			if(d1 != nullptr && d2 != nullptr)
+			{
+				active_automata.insert(StoreOperationResult(operation(*d1, *d2, ReportOperationResult())));
+				cout << operation_name << " successful!" << endl;
+			}
+			else
+			{
+				cout << "One or both of these automata don't exist" << endl;
+				return false;
+			}
+
+			cout << endl;
+			return true;
+		}
+	}
+
 	void PrintActiveAutomataIdentifiers(std::set<DFA*>& s)
 	{
 		for(DFA* d : s)
@@ -18,7 +96,7 @@ namespace slarx
 
 		cout << endl;
 	}
-	const DFA* GetAutomatonByID(uint32_t id, std::set<DFA*>& s)
+	DFA* GetAutomatonByID(uint32_t id, std::set<DFA*>& s)
 	{
 		auto iter = find_if(s.begin(), s.end(), [&id](const DFA* d){ return (d->GetIdentifier().GetValue() == id); });
 		if(iter != s.end())
@@ -85,6 +163,60 @@ namespace slarx
 			case Command::kInfinite:
 				success = IsInfiniteCommand(command, active_automata);
 				break;
+			case Command::kMinimize:
+				success = MinimizeCommand(command, active_automata);
+				break;
+			case Command::kAutoMinimize:
+				success = AutoMinimizeCommand(command, active_automata);
+				break;
+			case Command::kIntersection:
+				success = IntersectionCommand(command, active_automata);
+				break;
+			case Command::kDifference:
+				success = DifferenceCommand(command, active_automata);
+				break;
+			case Command::kSymmetricDifference:
+				success = SymmetricDifferenceCommand(command, active_automata);
+				break;
+			case Command::kProductUnion:
+				success = ProductUnionCommand(command, active_automata);
+				break;
+			case Command::kComplement:
+				success = ComplementCommand(command, active_automata);
+				break;
+			case Command::kRecognizeNFA:
+				success = RecognizeNFACommand(command, active_automata);
+				break;
+			case Command::kRecognizeFile:
+				success = RecognizeFileCommand(command, active_automata);
+				break;
+			case Command::kRecognizeBatch:
+				success = RecognizeBatchCommand(command, active_automata);
+				break;
+			case Command::kFind:
+				success = FindCommand(command, active_automata);
+				break;
+			case Command::kMultiScan:
+				success = MultiScanCommand(command, active_automata);
+				break;
+			case Command::kRecognizeStream:
+				success = RecognizeStreamCommand(command, active_automata);
+				break;
+			case Command::kRegex:
+				success = RegexCommand(command, active_automata);
+				break;
+			case Command::kDictionary:
+				success = DictionaryCommand(command, active_automata);
+				break;
+			case Command::kKeywords:
+				success = KeywordsCommand(command, active_automata);
+				break;
+			case Command::kFindKeywords:
+				success = FindKeywordsCommand(command, active_automata);
+				break;
+			case Command::kSuffixAutomaton:
+				success = SuffixAutomatonCommand(command, active_automata);
+				break;
 			case Command::kExit:
 				success = true;
 				break;
@@ -125,17 +257,60 @@ namespace slarx
 			return Command::kExit;
 		else if(beg == kInfinite)
 			return Command::kInfinite;
+		else if(beg == kMinimize)
+			return Command::kMinimize;
+		else if(beg == kAutoMinimize)
+			return Command::kAutoMinimize;
+		else if(beg == kIntersection)
+			return Command::kIntersection;
+		else if(beg == kDifference)
+			return Command::kDifference;
+		else if(beg == kSymmetricDifference)
+			return Command::kSymmetricDifference;
+		else if(beg == kProductUnion)
+			return Command::kProductUnion;
+		else if(beg == kComplement)
+			return Command::kComplement;
+		else if(beg == kRecognizeNFA)
+			return Command::kRecognizeNFA;
+		else if(beg == kRecognizeFile)
+			return Command::kRecognizeFile;
+		else if(beg == kRecognizeBatch)
+			return Command::kRecognizeBatch;
+		else if(beg == kFind)
+			return Command::kFind;
+		else if(beg == kMultiScan)
+			return Command::kMultiScan;
+		else if(beg == kRecognizeStream)
+			return Command::kRecognizeStream;
+		else if(beg == kRegex)
+			return Command::kRegex;
+		else if(beg == kDictionary)
+			return Command::kDictionary;
+		else if(beg == kKeywords)
+			return Command::kKeywords;
+		else if(beg == kFindKeywords)
+			return Command::kFindKeywords;
+		else if(beg == kSuffixAutomaton)
+			return Command::kSuffixAutomaton;
 		else
 			return Command::kInvalid;
 	}
 
-	std::string ExtractFilePath(const std::string& command)
+	// Returns the index-th quoted file path of the command or an empty string if there is no such path
+	std::string ExtractFilePath(const std::string& command, size_t index = 0)
 	{
-		std::stringstream s(command);
 		auto beg = std::find(command.begin(), command.end(), '\"');
 		auto end = beg;
 		if(beg != command.end())
 			end = std::find(beg + 1, command.end(), '\"');
+		for(; index > 0 && end != command.end(); --index)
+		{
+			beg = std::find(end + 1, command.end(), '\"');
+			end = beg;
+			if(beg != command.end())
+				end = std::find(beg + 1, command.end(), '\"');
+		}
 		std::string file_path;
 		if(beg != command.end() && end != command.end())
 			file_path = std::string(beg + 1, end);
@@ -219,7 +394,14 @@ namespace slarx
 		{
 			if(!file_path.empty())
 			{
-				d->Export(file_path);
+				if(HasBinaryFileExtension(file_path))
+				{
+					d->ExportBinary(file_path);
+				}
+				else
+				{
+					d->Export(file_path);
+				}
 				cout << "Save sucessful!" << endl << endl;
 			}
 			else
@@ -358,7 +540,7 @@ namespace slarx
 		const DFA* d2 = GetAutomatonByID(id2, active_automata);
 		if(d1 != nullptr && d2 != nullptr)
 		{
-			active_automata.insert(new DFA(AutomataUnion(*d1, *d2)));
+			active_automata.insert(StoreOperationResult(AutomataUnion(*d1, *d2, ReportOperationResult())));
 			cout << "Union successful!" << endl;
 		}
 		else
@@ -395,7 +577,7 @@ namespace slarx
 		const DFA* d2 = GetAutomatonByID(id2, active_automata);
 		if(d1 != nullptr && d2 != nullptr)
 		{
-			active_automata.insert(new DFA(AutomataConcatenation(*d1, *d2)));
+			active_automata.insert(StoreOperationResult(AutomataConcatenation(*d1, *d2, ReportOperationResult())));
 			cout << "Concatenation successful!" << endl;
 		}
 		else
@@ -422,7 +604,7 @@ namespace slarx
 		const DFA* d = GetAutomatonByID(id, active_automata);
 		if(d != nullptr)
 		{
-			active_automata.insert(new DFA(AutomataKleenyStar(*d)));
+			active_automata.insert(StoreOperationResult(AutomataKleenyStar(*d, ReportOperationResult())));
 			cout << "Kleeny closure successful!" << endl;
 		}
 		else
@@ -449,7 +631,7 @@ namespace slarx
 		const DFA* d = GetAutomatonByID(id, active_automata);
 		if(d != nullptr)
 		{
-			active_automata.insert(new DFA(AutomataConcatenation(*d, AutomataKleenyStar(*d))));
+			active_automata.insert(StoreOperationResult(AutomataConcatenation(*d, AutomataKleenyStar(*d, false), ReportOperationResult())));
 			cout << "Kleeny positive closure successful!" << endl;
 		}
 		else
@@ -460,4 +642,573 @@ namespace slarx
 		cout << endl;
 		return true;
 	}
-}
\ No newline at end of file
+
+	bool MinimizeCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+
+		const DFA* d = GetAutomatonByID(id, active_automata);
+		if(d != nullptr)
+		{
+			DFA* minimal = new DFA(MinimizeDFA(*d));
+			active_automata.insert(minimal);
+			cout << "Minimization successful! (" << d->Size() << " -> " << minimal->Size() << " states)" << endl;
+		}
+		else
+		{
+			cout << "Automaton does not exist" << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool AutoMinimizeCommand(const std::string& command, std::set<DFA*>&)
+	{
+		std::stringstream s(command);
+		std::string text;
+		s >> text; s >> text; // Ignore command text
+		if(text == "on")
+		{
+			minimize_operation_results = true;
+		}
+		else if(text == "off")
+		{
+			minimize_operation_results = false;
+		}
+		else
+		{
+			cout << "Expected on or off" << endl;
+			return false;
+		}
+		cout << "Automatic minimization is " << text << endl << endl;
+		return true;
+	}
+
+	bool IntersectionCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		return ProductCommand(command, active_automata, AutomataIntersection, "Intersection");
+	}
+
+	bool DifferenceCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		return ProductCommand(command, active_automata, AutomataDifference, "Difference");
+	}
+
+	bool SymmetricDifferenceCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		return ProductCommand(command, active_automata, AutomataSymmetricDifference, "Symmetric difference");
+	}
+
+	bool ProductUnionCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		return ProductCommand(command, active_automata, AutomataProductUnion, "Union");
+	}
+
+	bool ComplementCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+
+		DFA* d = GetAutomatonByID(id, active_automata);
+		if(d != nullptr)
+		{
+			d->Complement();
+			cout << "Complement successful!" << endl;
+		}
+		else
+		{
+			cout << "Automaton does not exist" << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool RecognizeNFACommand(const std::string& command, std::set<DFA*>&)
+	{
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			return false;
+		}
+		std::stringstream s(command.substr(command.rfind('\"') + 1));
+		std::string text;
+		s >> text;
+		if(s.fail())
+			text.clear();
+		std::string engine_name;
+		s >> engine_name;
+		if(s.fail())
+			engine_name = "auto";
+
+		try
+		{
+			ConversionNFA nfa(file_path);
+			NFARecognizer recognizer(nfa, ParseRecognitionEngine(engine_name));
+			if(recognizer.Recognize(text))
+			{
+				cout << "Yes!" << endl;
+			}
+			else
+			{
+				cout << "No." << endl;
+			}
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool RecognizeFileCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			return false;
+		}
+		const DFA* d = GetAutomatonByID(id, active_automata);
+		if(d == nullptr)
+		{
+			cout << "Automaton not found!" << endl;
+			return false;
+		}
+
+		try
+		{
+			MappedFile file(file_path);
+			if(RecognizeParallel(*d, file.GetData(), file.Size()))
+			{
+				cout << "Yes!" << endl;
+			}
+			else
+			{
+				cout << "No." << endl;
+			}
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool RecognizeBatchCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+		std::string words_path = ExtractFilePath(command, 0);
+		std::string results_path = ExtractFilePath(command, 1);
+		if(words_path.empty() || results_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+		const DFA* d = GetAutomatonByID(id, active_automata);
+		if(d == nullptr)
+		{
+			cout << "Automaton not found!" << endl;
+			return false;
+		}
+
+		try
+		{
+			MappedFile words_file(words_path);
+			std::vector<std::string_view> words = SplitLines(words_file.GetData(), words_file.Size());
+
+			std::vector<uint64_t> results = d->RecognizeBatch(words);
+			std::ofstream results_file;
+			if(HasBinaryFileExtension(results_path))
+			{
+				results_file.open(results_path, std::ios::binary);
+				results_file.write(reinterpret_cast<const char*>(results.data()), results.size() * sizeof(uint64_t));
+			}
+			else
+			{
+				std::string text(2 * words.size(), '\n');
+				for(size_t i = 0; i < words.size(); ++i)
+				{
+					text[ 2 * i ] = (results[ i / 64 ] >> (i % 64)) & 1 ? '1' : '0';
+				}
+				results_file.open(results_path, std::ios::binary);
+				results_file.write(text.data(), text.size());
+			}
+			if(!results_file)
+			{
+				cout << "Failed to write " << results_path << endl;
+				return false;
+			}
+
+			size_t recognized = 0;
+			for(uint64_t result_bits : results)
+			{
+				recognized += std::bitset<64>(result_bits).count();
+			}
+			cout << "Recognized " << recognized << " of " << words.size() << " words." << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool FindCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+		std::stringstream s(command.substr(command.rfind('\"') + 1));
+		std::string kind;
+		s >> kind;
+		const DFA* d = GetAutomatonByID(id, active_automata);
+		if(d == nullptr)
+		{
+			cout << "Automaton not found!" << endl;
+			return false;
+		}
+
+		try
+		{
+			MappedFile file(file_path);
+			DFASearcher searcher(*d, kind == "all" ? MatchKind::kAll : MatchKind::kLeftmostLongest);
+			std::string output;
+			size_t number_of_matches = 0;
+			searcher.Find(file.GetData(), file.Size(), [&](const Match& match)
+			{
+				output += std::to_string(match.begin) + " " + std::to_string(match.end) + "\n";
+				++number_of_matches;
+				return true;
+			});
+			cout << output << number_of_matches << " matches found." << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool MultiScanCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+		std::stringstream s(command.substr(command.rfind('\"') + 1));
+		std::string text;
+		ScanKind kind = ScanKind::kAccept;
+		std::vector<const DFA*> automata;
+		while(s >> text)
+		{
+			if(text == "match" && automata.empty())
+			{
+				kind = ScanKind::kMatch;
+				continue;
+			}
+			uint32_t id;
+			try
+			{
+				id = IntegerParse(text)[ 0 ];
+			}
+			catch(std::invalid_argument)
+			{
+				return false;
+			}
+			const DFA* d = GetAutomatonByID(id, active_automata);
+			if(d == nullptr)
+			{
+				cout << "Automaton not found!" << endl;
+				return false;
+			}
+			automata.push_back(d);
+		}
+		if(automata.empty())
+		{
+			automata.assign(active_automata.begin(), active_automata.end());
+		}
+
+		try
+		{
+			MappedFile file(file_path);
+			MultiPatternScanner scanner(automata, kind);
+			std::vector<uint32_t> identifiers = scanner.Scan(file.GetData(), file.Size());
+			cout << (kind == ScanKind::kAccept ? "Accepted by " : "Matched by ") << identifiers.size() << " of " << automata.size() << " automata:";
+			for(uint32_t id : identifiers)
+			{
+				cout << " " << id;
+			}
+			cout << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool RecognizeStreamCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		uint32_t id;
+		try
+		{
+			id = ExtractIdFromCommand(command);
+		}
+		catch(std::invalid_argument)
+		{
+			return false;
+		}
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			return false;
+		}
+		const DFA* d = GetAutomatonByID(id, active_automata);
+		if(d == nullptr)
+		{
+			cout << "Automaton not found!" << endl;
+			return false;
+		}
+
+		std::ifstream input(file_path, std::ios::binary);
+		if(!input)
+		{
+			cout << "Could not open " << file_path << endl;
+			return false;
+		}
+		const size_t kBlockSize = 1 << 16;
+		std::vector<char> block(kBlockSize);
+		DFAStreamMatcher matcher(*d);
+		while(!matcher.IsDecided() && input)
+		{
+			input.read(block.data(), block.size());
+			matcher.Feed(block.data(), static_cast<size_t>(input.gcount()));
+		}
+		if(matcher.Finish())
+		{
+			cout << "Yes!" << endl;
+		}
+		else
+		{
+			cout << "No." << endl;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool RegexCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		const size_t begin = command.find('\"');
+		const size_t end = command.rfind('\"');
+		if(begin == std::string::npos || end == begin)
+		{
+			cout << "The regular expression must be quoted" << endl;
+			return false;
+		}
+
+		std::stringstream s(command.substr(end + 1));
+		std::string engine_name;
+		s >> engine_name;
+		if(s.fail())
+			engine_name = "glushkov";
+
+		try
+		{
+			const RegexEngine engine = ParseRegexEngine(engine_name);
+			active_automata.insert(StoreOperationResult(CompileRegex(command.substr(begin + 1, end - begin - 1), engine, ReportOperationResult())));
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << "Regular expression compiled!" << endl;
+		cout << endl;
+		return true;
+	}
+
+	bool DictionaryCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+		std::stringstream s(command.substr(command.rfind('\"') + 1));
+		std::string order;
+		s >> order;
+		const bool is_sorted = order != "unsorted";
+
+		try
+		{
+			MappedFile words_file(file_path);
+			std::vector<std::string_view> words = SplitLines(words_file.GetData(), words_file.Size());
+			// The result is minimal already, so it is not minimized again
+			active_automata.insert(new DFA(BuildDictionaryDFA(words, is_sorted), true));
+			cout << "Dictionary built!" << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool KeywordsCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		std::string file_path = ExtractFilePath(command);
+		if(file_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+
+		try
+		{
+			MappedFile keywords_file(file_path);
+			AhoCorasickAutomaton automaton(SplitLines(keywords_file.GetData(), keywords_file.Size()), true);
+			active_automata.insert(new DFA(automaton.ReleaseDFA(), false));
+			cout << "Keyword search automaton built!" << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool FindKeywordsCommand(const std::string& command, std::set<DFA*>&)
+	{
+		std::string keywords_path = ExtractFilePath(command, 0);
+		std::string text_path = ExtractFilePath(command, 1);
+		if(keywords_path.empty() || text_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+
+		try
+		{
+			MappedFile keywords_file(keywords_path);
+			std::vector<std::string_view> keywords = SplitLines(keywords_file.GetData(), keywords_file.Size());
+			AhoCorasickAutomaton automaton(keywords);
+			MappedFile text_file(text_path);
+			std::string output;
+			size_t number_of_matches = 0;
+			automaton.Scan(text_file.GetData(), text_file.Size(), [&](uint32_t keyword, size_t end)
+			{
+				output += std::to_string(end - keywords[ keyword ].size()) + " " + std::to_string(end) + " " + std::to_string(keyword) + "\n";
+				++number_of_matches;
+				return true;
+			});
+			cout << output << number_of_matches << " matches found." << endl;
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+
+	bool SuffixAutomatonCommand(const std::string& command, std::set<DFA*>& active_automata)
+	{
+		std::string text_path = ExtractFilePath(command, 0);
+		if(text_path.empty())
+		{
+			cout << "Invalid file path" << endl;
+			return false;
+		}
+		std::string queries_path = ExtractFilePath(command, 1);
+
+		try
+		{
+			MappedFile text_file(text_path);
+			// The creation is reported once the automaton is stored, since answering the queries may still fail
+			SuffixAutomaton automaton(text_file.GetData(), text_file.Size());
+			cout << "Suffix automaton built! The text has " << automaton.CountDistinctSubstrings() << " distinct nonempty substrings." << endl;
+			if(!queries_path.empty())
+			{
+				MappedFile queries_file(queries_path);
+				std::string output;
+				for(std::string_view query : SplitLines(queries_file.GetData(), queries_file.Size()))
+				{
+					const size_t first = automaton.FindFirstOccurrence(query);
+					output += std::to_string(automaton.CountOccurrences(query)) + " " + (first == SuffixAutomaton::kNotFound ? "-1" : std::to_string(first)) + "\n";
+				}
+				cout << output;
+			}
+			active_automata.insert(new DFA(automaton.ReleaseDFA(), true));
+		}
+		catch(std::invalid_argument e)
+		{
+			cout << e.what() << endl;
+			return false;
+		}
+		cout << endl;
+		return true;
+	}
+}
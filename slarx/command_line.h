@@ -10,9 +10,11 @@
 namespace slarx
 {
 	void PrintActiveAutomataIdentifiers(std::set<DFA*>& s);
-	const DFA* GetAutomatonByID(uint32_t id, std::set<DFA*>& active_automata);
+	DFA* GetAutomatonByID(uint32_t id, std::set<DFA*>& active_automata);
 
-	enum class Command{ kOpen, kList, kPrint, kSave, kIsEmpty, kRecognize, kUnion, kConcatenation, kKleeny, kKleenyPositive, kExit, kInvalid, kInfinite };
+	enum class Command{ kOpen, kList, kPrint, kSave, kIsEmpty, kRecognize, kUnion, kConcatenation, kKleeny, kKleenyPositive, kExit, kInvalid, kInfinite, kMinimize, kAutoMinimize,
+						 kIntersection, kDifference, kSymmetricDifference, kProductUnion, kComplement, kRecognizeNFA, kRecognizeFile, kRecognizeBatch, kFind,
+						 kMultiScan, kRecognizeStream, kRegex, kDictionary, kKeywords, kFindKeywords, kSuffixAutomaton };
 	const std::string kOpen = "open";
 	const std::string kList = "list";
 	const std::string kPrint = "print";
@@ -25,6 +27,26 @@ namespace slarx
 	const std::string kKleenyPositive = "kleeny+";
 	const std::string kExit = "exit";
 	const std::string kInfinite = "inf";
+	const std::string kMinimize = "min";
+	const std::string kAutoMinimize = "automin";
+	const std::string kIntersection = "inter";
+	const std::string kDifference = "diff";
+	const std::string kSymmetricDifference = "symdiff";
+	const std::string kProductUnion = "punion";
+	const std::string kComplement = "compl";
+	const std::string kRecognizeNFA = "nreco";
+	const std::string kRecognizeFile = "freco";
+	const std::string kRecognizeBatch = "breco";
+	const std::string kFind = "find";
+	const std::string kMultiScan = "mscan";
+	const std::string kRecognizeStream = "sreco";
+	const std::string kRegex = "regex";
+	const std::string kDictionary = "dict";
+	const std::string kKeywords = "keywords";
+	const std::string kFindKeywords = "kwfind";
+	const std::string kSuffixAutomaton = "suffix";
+	// The save command writes automata with this extension in the binary format. open detects the format by itself
+	const std::string kBinaryFileExtension = ".bin";
 
 	// Initializes execution. Should be used only once at the start of execution
 	void Run();
@@ -41,6 +63,43 @@ namespace slarx
 	bool ConcatenationCommand(const std::string& command, std::set<DFA*>& active_automata);
 	bool KleenyClosureCommand(const std::string& command, std::set<DFA*>& active_automata);
 	bool KleenyPositiveClosureCommand(const std::string& command, std::set<DFA*>& active_automata);
+	bool MinimizeCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Turns automatic minimization of the results of union, concatenation and Kleeny closures on or off
+	bool AutoMinimizeCommand(const std::string& command, std::set<DFA*>& active_automata);
+	bool IntersectionCommand(const std::string& command, std::set<DFA*>& active_automata);
+	bool DifferenceCommand(const std::string& command, std::set<DFA*>& active_automata);
+	bool SymmetricDifferenceCommand(const std::string& command, std::set<DFA*>& active_automata);
+	bool ProductUnionCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Complements an active automaton in place
+	bool ComplementCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Recognizes a word with an automaton file without opening it as a DFA. An engine (auto, dfa, lazy or bits) may follow the word
+	bool RecognizeNFACommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Recognizes the whole contents of a file as a single word, splitting the work across all hardware threads
+	bool RecognizeFileCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Recognizes every line of a word file and writes the results to a result file, either as a bitmap (for the
+	// binary file extension) or as a text file with a 1 or 0 on every line
+	bool RecognizeBatchCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Prints the start and end offsets of the occurrences of an automaton's words in a file. Leftmost-longest matches
+	// are printed, unless the path is followed by "all"
+	bool FindCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Scans a file once with several automata and prints the ones, which accept it, or with "match" after the path, the ones
+	// which accept a part of it. The IDs of the automata may follow, otherwise all active automata are used
+	bool MultiScanCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Recognizes the contents of a file as a single word, reading it in blocks, so that pipes and devices work too
+	bool RecognizeStreamCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Compiles the regular expression between the first and the last quote of the command (see ParseRegex) into a new active automaton.
+	// The engine (glushkov or derivatives) may follow the expression and is glushkov by default
+	bool RegexCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Builds the minimal DFA of the words in a file (one word per line), which must be sorted unless "unsorted" follows the path
+	bool DictionaryCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Builds the Aho-Corasick search DFA of the keywords in a file (one keyword per line), which accepts the words ending with a keyword
+	bool KeywordsCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Finds the occurrences of the keywords in the first file (one keyword per line) in the second file. Prints the begin and the
+	// end of every occurrence and the ID of its keyword, which is its line number starting from 0
+	bool FindKeywordsCommand(const std::string& command, std::set<DFA*>& active_automata);
+	// Builds the suffix automaton of the text in the first file, which accepts its substrings. If a second file is given, prints
+	// the number of occurrences and the first position (or -1) in the text of every line of it
+	bool SuffixAutomatonCommand(const std::string& command, std::set<DFA*>& active_automata);
 }
 
 #endif // SLARX_COMMAND_LINE_H_INCLUDED
@@ -41,49 +41,61 @@ namespace slarx
 		}
 	}
 
+	ByteClasses ConversionNFATransitionTable::ComputeByteClasses(const Alphabet& alphabet) const
+	{
+		ByteClasses classes(alphabet, false);
+		std::map<std::set<State>, uint32_t> target_set_ids;
+		for(const auto& row : transitions_)
+		{
+			if(row.empty())
+				continue;
+
+			std::array<uint32_t, 256> key;
+			key.fill(0);
+			for(const auto& on_to : row)
+			{
+				auto inserted = target_set_ids.insert(std::make_pair(on_to.second, static_cast<uint32_t>(target_set_ids.size() + 1)));
+				key[ static_cast<unsigned char>(on_to.first) ] = inserted.first->second;
+			}
+			classes.Refine([&key](unsigned char c) -> uint32_t { return key[ c ]; });
+		}
+		return classes;
+	}
+
 	bool ConversionNFA::ReadFromFile(const std::string& path)
 	{
-		std::ifstream input_file(path);
-		std::string line;
+		MappedFile file(path);
+		AutomatonTextParser parser(file.GetData(), file.Size(), "NFA");
+		parser.ReadType(); // Discard automaton type specifier
+		return ReadFromParser(parser);
+	}
 
+	bool ConversionNFA::ReadFromParser(AutomatonTextParser& parser)
+	{
 		uint32_t number_of_states;
 		Alphabet alphabet;
 		State start_state;
 		std::set<State> accepting_states;
-		std::vector<int> integers;
 		
-		ReadAutomatonData(input_file, number_of_states, alphabet, start_state, accepting_states);
+		parser.SetAutomatonKind("NFA");
+		parser.ReadAutomatonData(number_of_states, alphabet, start_state, accepting_states);
 		alphabet.AddCharacter(kEpsilon);
 
 		ConversionNFATransitionTable transition_table(number_of_states, alphabet);
-		int line_number = 5;
-		while(getline(input_file, line))
+		uint32_t from, to;
+		char on;
+		while(parser.ReadTransition(from, on, to))
 		{
-			std::vector<std::string> tokens = Tokenize(line, ' ');
-			if(tokens.size() == 3)
+			if(from < number_of_states && to < number_of_states)
 			{
-				unsigned from = IntegerParse(tokens[ 0 ])[ 0 ];
-				char on = tokens[ 1 ][ 0 ]; // TODO: this should check if tokens[1] is really a single character
-				unsigned to = IntegerParse(tokens[ 2 ])[ 0 ];
-				if(from >= 0 && from <= number_of_states && to >= 0 && to <= number_of_states)
-				{
-					transition_table.AddTransition(State(from), on, State(to));
-				}
-				else
-				{
-					std::stringstream error_message;
-					error_message << "Line " << line_number << " (transition of NFA) - transition contains an unexisting state!";
-					throw(std::invalid_argument(error_message.str()));
-				}
+				transition_table.AddTransition(State(from), on, State(to));
 			}
 			else
 			{
 				std::stringstream error_message;
-				error_message << "Line " << line_number << " (transition of NFA) contains too many or too few arguments! (should be 3)";
+				error_message << "Line " << parser.GetLineNumber() - 1 << " (transition of NFA) - transition contains an unexisting state!";
 				throw(std::invalid_argument(error_message.str()));
 			}
-
-			++line_number;
 		}
 
 		*this = ConversionNFA(number_of_states, alphabet, start_state, accepting_states, transition_table);
@@ -96,156 +108,140 @@ namespace slarx
 		alphabet_.AddCharacter(kEpsilon);
 		for(size_t from = 0; from < dfa.Size(); ++from)
 		{
-			for(auto on_to : dfa.GetTransitionTable().GetTransitions()[ from ])
+			for(char on : dfa.GetAlphabet().GetCharacters())
 			{
-				transition_table_.AddTransition(State(from), on_to.first, on_to.second);
+				State to = dfa.GetTransitionTable().GetTransition(State(from), on);
+				if(to.IsInitialized())
+				{
+					transition_table_.AddTransition(State(from), on, to);
+				}
 			}
 		}
 	}
 
-	DFA ConversionNFA::ToDFA()
+	EpsilonClosureTable::EpsilonClosureTable(const ConversionNFATransitionTable& transition_table, uint32_t number_of_states)
+		: number_of_words_((number_of_states + 63) / 64), component_of_(number_of_states)
 	{
-		std::set<std::set<State> > dfa_states;
-		dfa_states.insert(EpsilonClosure(GetStartState())); // Insert start state
-		dfa_states.insert(std::set<State>()); // Insert error state
-		Alphabet dfa_alphabet = GetAlphabet();
-		dfa_alphabet.RemoveCharacter(kEpsilon);
-
-		auto new_dfa_states = dfa_states;
-		do
+		std::vector<uint32_t> offsets(number_of_states + 1, 0);
+		std::vector<uint32_t> targets;
+		for(uint32_t from = 0; from < number_of_states; ++from)
 		{
-			dfa_states = new_dfa_states;
-			for(auto powerset_state : dfa_states)
+			for(State to : transition_table.GetTransition(State(from), kEpsilon))
 			{
-				for(char c : dfa_alphabet.GetCharacters())
-				{
-					std::set<State> new_state;
-					//new_state.insert(powerset_state.begin(), powerset_state.end());
-					for(State s : powerset_state)
-					{
-						auto transition = transition_table_.GetTransition(s, c);
-						new_state.insert(transition.begin(), transition.end());
-					}
-					new_state = EpsilonClosure(new_state);
-					new_dfa_states.insert(new_state);
-				}
+				targets.push_back(to.GetValue());
 			}
-		}while(new_dfa_states != dfa_states);
-		
-
-		std::vector<std::set<State> > dfa_states_vector(dfa_states.begin(), dfa_states.end());
-		State dfa_start_state = State(std::find(dfa_states_vector.begin(), dfa_states_vector.end(), EpsilonClosure(GetStartState())) - dfa_states_vector.begin());
-		State dfa_error_state = State(std::find(dfa_states_vector.begin(), dfa_states_vector.end(), std::set<State>()) - dfa_states_vector.begin());
+			offsets[ from + 1 ] = targets.size();
+		}
+		DirectedGraph epsilon_graph(std::move(offsets), std::move(targets));
 
-		DFATransitionTable dfa_transition_table(dfa_states.size(), dfa_alphabet);
+		std::vector<std::vector<uint32_t> > components = FindSCC(epsilon_graph);
+		for(uint32_t i = 0; i < components.size(); ++i)
+		{
+			for(uint32_t state : components[ i ])
+			{
+				component_of_[ state ] = i;
+			}
+		}
 
-		// If there is a transition from any state of the the epsilon closed state i 
-		// to any state of the epsilon closed state j on char c
-		// we add (i, c, j) to the updated transition table
-		for(int i = 0; i < dfa_states_vector.size(); ++i)
+		// Components come in topological order, so every component reachable from component i has already been closed
+		closures_.assign(components.size() * static_cast<size_t>(number_of_words_), 0);
+		for(size_t i = components.size(); i-- > 0;)
 		{
-			for(int j = i; j < dfa_states_vector.size(); ++j)
+			uint64_t* closure = &closures_[ i * number_of_words_ ];
+			for(uint32_t state : components[ i ])
 			{
-				for(char c : dfa_alphabet.GetCharacters())
+				closure[ state / 64 ] |= uint64_t(1) << (state % 64);
+			}
+			for(uint32_t state : components[ i ])
+			{
+				for(uint32_t to : epsilon_graph[ state ])
 				{
-					std::set<State> i_to_j_transition;
-					for(State x : dfa_states_vector[ i ])
-					{
-						auto transition = transition_table_.GetTransition(x, c);
-						i_to_j_transition.insert(transition.begin(), transition.end());
-					}
-					i_to_j_transition = EpsilonClosure(i_to_j_transition);
-					if(std::equal(i_to_j_transition.begin(), i_to_j_transition.end(), dfa_states_vector[ j ].begin(), dfa_states_vector[ j ].end()))
-					{
-						dfa_transition_table.AddTransition(State(i), c, State(j));
-					}
-
-					if(i != j)
+					if(component_of_[ to ] != i)
 					{
-						std::set<State> j_to_i_transition;
-						for(State y : dfa_states_vector[ j ])
-						{
-							auto transition = transition_table_.GetTransition(y, c);
-							j_to_i_transition.insert(transition.begin(), transition.end());
-
-						}
-						j_to_i_transition = EpsilonClosure(j_to_i_transition);
-						if(std::equal(j_to_i_transition.begin(), j_to_i_transition.end(), dfa_states_vector[ i ].begin(), dfa_states_vector[ i ].end()))
-						{
-							dfa_transition_table.AddTransition(State(j), c, State(i));
-						}
+						AddClosure(to, closure);
 					}
 				}
-
 			}
 		}
+	}
 
-		for(int i = 0; i < dfa_states_vector.size(); ++i)
+	DFA ConversionNFA::ToDFA(bool report_automaton_was_created)
+	{
+		Alphabet dfa_alphabet = GetAlphabet();
+		dfa_alphabet.RemoveCharacter(kEpsilon);
+		// Characters with identical transitions lead to the same DFA state, so only one character of every class is considered
+		ByteClasses dfa_classes = transition_table_.ComputeByteClasses(dfa_alphabet);
+		std::vector<char> class_representatives = dfa_classes.GetRepresentatives();
+		EpsilonClosureTable epsilon_closures(transition_table_, Size());
+		const uint32_t words = epsilon_closures.GetNumberOfWords();
+
+		// Targets of the transitions from every state on every class of characters
+		std::vector<std::vector<uint32_t> > class_transitions(static_cast<size_t>(Size()) * class_representatives.size());
+		for(uint32_t from = 0; from < Size(); ++from)
 		{
-			for(char c : dfa_alphabet.GetCharacters())
+			for(size_t k = 0; k < class_representatives.size(); ++k)
 			{
-				// If no transition from state i on c, it must go to error state
-				if(dfa_transition_table.GetTransition(State(i), c) == State())
+				for(State to : transition_table_.GetTransition(State(from), class_representatives[ k ]))
 				{
-					dfa_transition_table.AddTransition(State(i), c, dfa_error_state);
+					class_transitions[ from * class_representatives.size() + k ].push_back(to.GetValue());
 				}
 			}
 		}
-
-		std::set<State> dfa_accepting_states;
-		for(int i = 0; i < dfa_states_vector.size(); ++i)
+		std::vector<uint64_t> nfa_accepting_states(words, 0);
+		for(State s : GetAcceptingStates())
 		{
-			std::vector<State> intersection;
-			std::set_intersection(dfa_states_vector[ i ].begin(), dfa_states_vector[ i ].end(),
-								  GetAcceptingStates().begin(), GetAcceptingStates().end(),
-								  std::back_inserter(intersection));
-
-			if(intersection.size() > 0)
-				dfa_accepting_states.insert(State(i));
+			nfa_accepting_states[ s.GetValue() / 64 ] |= uint64_t(1) << (s.GetValue() % 64);
 		}
 
-
-		uint32_t dfa_number_of_states = dfa_states.size();
-
-		return DFA(std::move(dfa_number_of_states), std::move(dfa_alphabet), std::move(dfa_start_state)
-				   ,std::move(dfa_accepting_states), std::move(dfa_transition_table), true);
-	}
-
-	std::set<State> ConversionNFA::EpsilonClosure(State state)
-	{
-		std::set<State> epsilon_closure;
-		epsilon_closure.insert(state);
-		std::set<State> epsilon_closure_new(epsilon_closure);
-		do
+		// DFA state i is the epsilon closed set of NFA states *dfa_states[ i ] (a key of dfa_state_index), stored as a bit row.
+		// States, which are not yet processed, form the tail of dfa_states, so the vector also serves as the worklist
+		std::vector<const std::vector<uint64_t>*> dfa_states;
+		std::unordered_map<std::vector<uint64_t>, uint32_t, ContainerHash> dfa_state_index;
+		std::set<State> dfa_accepting_states;
+		DFATransitionTable dfa_transition_table(0, dfa_alphabet, dfa_classes);
+		auto find_or_add_dfa_state = [&](std::vector<uint64_t>&& powerset_state) -> State
 		{
-			epsilon_closure = epsilon_closure_new;
-			for(State i : epsilon_closure)
+			auto inserted = dfa_state_index.insert(std::make_pair(std::move(powerset_state), static_cast<uint32_t>(dfa_states.size())));
+			if(inserted.second)
 			{
-				auto transition = transition_table_.GetTransition(i, kEpsilon);
-				// Set union
-				epsilon_closure_new.insert(transition.begin(), transition.end());
+				for(uint32_t w = 0; w < words; ++w)
+				{
+					if(inserted.first->first[ w ] & nfa_accepting_states[ w ])
+					{
+						dfa_accepting_states.insert(State(inserted.first->second));
+						break;
+					}
+				}
+				dfa_states.push_back(&inserted.first->first);
+				dfa_transition_table.SetNumberOfStates(dfa_states.size());
 			}
-		}while(epsilon_closure_new != epsilon_closure);
-		
+			return State(inserted.first->second);
+		};
 
-		return epsilon_closure;
-	}
-
-	std::set<State> ConversionNFA::EpsilonClosure(const std::set<State>& state)
-	{
-		std::set<State> epsilon_closure(state.begin(), state.end());
-		auto new_epsilon_closure = epsilon_closure;
-		do
+		std::vector<uint64_t> start_state(words, 0);
+		epsilon_closures.AddClosure(GetStartState().GetValue(), start_state.data());
+		State dfa_start_state = find_or_add_dfa_state(std::move(start_state));
+		for(uint32_t i = 0; i < dfa_states.size(); ++i)
 		{
-			epsilon_closure = new_epsilon_closure;
-			for(State s : epsilon_closure)
+			for(size_t k = 0; k < class_representatives.size(); ++k)
 			{
-				auto s_epsilon_closure = EpsilonClosure(s);
-				new_epsilon_closure.insert(s_epsilon_closure.begin(), s_epsilon_closure.end());
+				std::vector<uint64_t> new_state(words, 0);
+				ForEachSetBit(dfa_states[ i ]->data(), words, [&](uint32_t s)
+				{
+					for(uint32_t to : class_transitions[ s * class_representatives.size() + k ])
+					{
+						epsilon_closures.AddClosure(to, new_state.data());
+					}
+				});
+				// The empty set becomes the error state if it is ever reached
+				State to = find_or_add_dfa_state(std::move(new_state));
+				dfa_transition_table.AddTransition(State(i), class_representatives[ k ], to);
 			}
-		}while(new_epsilon_closure != epsilon_closure);
-		
-		return epsilon_closure;
-	}
-}
+		}
 
+		uint32_t dfa_number_of_states = dfa_states.size();
+
+		return DFA(std::move(dfa_number_of_states), std::move(dfa_alphabet), std::move(dfa_start_state)
+				   ,std::move(dfa_accepting_states), std::move(dfa_transition_table), report_automaton_was_created);
+	}
+}
\ No newline at end of file
@@ -30,6 +30,8 @@ namespace slarx
 		const std::set<State> GetTransition(State from, char on) const;
 		void SetAlphabet(const Alphabet& alphabet) { conversion_nfa_alphabet_ = alphabet; }
 		const TransitionTable& GetTransitions() const { return transitions_; }
+		// Groups the characters of alphabet into classes, where two characters share a class if every state has the same set of transitions on both
+		ByteClasses ComputeByteClasses(const Alphabet& alphabet) const;
 		friend void swap(ConversionNFATransitionTable& a, ConversionNFATransitionTable& b) noexcept;
 
 	private:
@@ -37,6 +39,36 @@ namespace slarx
 		Alphabet conversion_nfa_alphabet_;
 	};
 
+	// Epsilon closures of all states of a ConversionNFA, computed once per automaton. Every closure is a bit row
+	// with one bit per state. States in the same strongly connected component of the epsilon transitions have
+	// the same closure, so rows are stored once per component and computed in reverse topological order
+	class EpsilonClosureTable
+	{
+	public:
+		EpsilonClosureTable(const ConversionNFATransitionTable& transition_table, uint32_t number_of_states);
+
+		// Number of 64-bit words in a row
+		uint32_t GetNumberOfWords() const { return number_of_words_; }
+		const uint64_t* GetClosure(uint32_t state) const { return &closures_[ static_cast<size_t>(component_of_[ state ]) * number_of_words_ ]; }
+		// Adds the epsilon closure of state to the bit row subset. Does nothing if state is already in subset,
+		// because subset is then already closed under its epsilon transitions
+		void AddClosure(uint32_t state, uint64_t* subset) const
+		{
+			if(subset[ state / 64 ] & (uint64_t(1) << (state % 64)))
+				return;
+			const uint64_t* closure = GetClosure(state);
+			for(uint32_t w = 0; w < number_of_words_; ++w)
+			{
+				subset[ w ] |= closure[ w ];
+			}
+		}
+
+	private:
+		uint32_t number_of_words_;
+		std::vector<uint32_t> component_of_;
+		std::vector<uint64_t> closures_;
+	};
+
 	// This is a utility class, which is to be used when reading an
 	// automaton of unknown type (or a known NFA) or when performing
 	// operations on a DFA, which produce an NFA (such as union,
@@ -53,9 +85,12 @@ namespace slarx
 			: number_of_states_(number_of_states), alphabet_(alphabet), start_state_(start_state), accepting_states_(accepting_states), transition_table_(transition_table) { }
 		ConversionNFA(const DFA& dfa);
 		ConversionNFA(const std::string& path) { ReadFromFile(path); }
+		// Reads the NFA from a parser, which is past the type specifier
+		explicit ConversionNFA(AutomatonTextParser& parser) { ReadFromParser(parser); }
 		virtual ~ConversionNFA() = default;
 		// Reads information for an Automaton from the file located at path 
 		bool ReadFromFile(const std::string& path);
+		bool ReadFromParser(AutomatonTextParser& parser);
 
 		uint32_t Size() const { return number_of_states_; }
 		const Alphabet& GetAlphabet() const { return alphabet_; }
@@ -65,7 +100,7 @@ namespace slarx
 		// TODO - Decide if necessary
 		friend void swap(ConversionNFA& a, ConversionNFA& b) noexcept;
 
-		DFA ToDFA();// const;
+		DFA ToDFA(bool report_automaton_was_created = true);// const;
 
 	protected:
 		// Returns an identifier and increments last_assigned_id_
@@ -83,12 +118,6 @@ namespace slarx
 		State start_state_;
 		std::set<State> accepting_states_;
 		ConversionNFATransitionTable transition_table_;
-
-		
-		// Produces the epsilon closure of a state
-		std::set<State> EpsilonClosure(State state);
-		// Produces epsilon closure of a composite state
-		std::set<State> ConversionNFA::EpsilonClosure(const std::set<State>& state);
 	};
 }
 
@@ -1,4 +1,5 @@
 #include "slarx.h"
+#include "interleaved_run.h"
 
 #include <exception>
 #include <string>
@@ -6,31 +7,57 @@
 #include <fstream>
 #include <sstream>
 #include <queue>
+#include <cstring>
 
 namespace slarx
 {
+	const uint32_t DFATransitionTable::kNoTransition;
+
+	DFATransitionTable::DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet)
+		: DFATransitionTable(dfa_number_of_states, dfa_alphabet, ByteClasses(dfa_alphabet, true))
+	{
+	}
+
+	DFATransitionTable::DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet, const ByteClasses& classes)
+		: transitions_(static_cast<size_t>(dfa_number_of_states) * classes.Size(), kNoTransition), mapped_transitions_(nullptr), classes_(classes),
+		  number_of_states_(dfa_number_of_states), number_of_columns_(classes.Size()), is_finalized_(false), dfa_alphabet_(dfa_alphabet)
+	{
+	}
+
+	DFATransitionTable::DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet, const ByteClasses& classes,
+										   std::shared_ptr<const MappedFile> mapping, const uint32_t* transitions)
+		: mapping_(std::move(mapping)), mapped_transitions_(transitions), classes_(classes),
+		  number_of_states_(dfa_number_of_states), number_of_columns_(classes.Size()), is_finalized_(true), dfa_alphabet_(dfa_alphabet)
+	{
+	}
+
 	void DFATransitionTable::AddTransition(State from, char on, State to)
 	{
-		if(GetTransition(from, on) != State())
+		uint32_t column = GetColumn(on);
+		if(is_finalized_)
 		{
-			throw std::invalid_argument("Attemped to add more than one transition from a State on same character.");
+			throw std::logic_error("Attempted to add a transition to a finalized DFA transition table.");
 		}
-		else if(!dfa_alphabet_.Contains(on))
+		else if(column == 0)
 		{
 			throw std::domain_error("Attempted to add transition on a character, which is not part of the DFA's alphabet.");
 		}
+		else if(transitions_[ static_cast<size_t>(from.GetValue()) * number_of_columns_ + column ] != kNoTransition)
+		{
+			throw std::invalid_argument("Attemped to add more than one transition from a State on same character.");
+		}
 		else
 		{
-			transitions_[from.GetValue()][on] = to;
+			transitions_[ static_cast<size_t>(from.GetValue()) * number_of_columns_ + column ] = to.GetValue();
 		}
 	}
 
 	const State DFATransitionTable::GetTransition(State from, char on) const
 	{
-		auto iterator = transitions_[from.GetValue()].find(on);
-		if(iterator != transitions_[from.GetValue()].end())
+		uint32_t to = GetData()[ static_cast<size_t>(from.GetValue()) * number_of_columns_ + GetColumn(on) ];
+		if(to != kNoTransition && to != GetSinkState())
 		{
-			return iterator->second;
+			return State(to);
 		}
 		else
 		{
@@ -38,35 +65,101 @@ namespace slarx
 		}
 	}
 
+	void DFATransitionTable::SetNumberOfStates(unsigned dfa_number_of_states)
+	{
+		if(is_finalized_)
+		{
+			throw std::logic_error("Attempted to resize a finalized DFA transition table.");
+		}
+		number_of_states_ = dfa_number_of_states;
+		transitions_.resize(static_cast<size_t>(number_of_states_) * number_of_columns_, kNoTransition);
+	}
+
+	void DFATransitionTable::Finalize()
+	{
+		if(is_finalized_)
+			return;
+
+		uint32_t sink = GetSinkState();
+		transitions_.resize(static_cast<size_t>(number_of_states_ + 1) * number_of_columns_, kNoTransition);
+		std::replace(transitions_.begin(), transitions_.end(), kNoTransition, sink);
+
+		// Two characters share a class only if every state has the same transition on both of them
+		ByteClasses merged_classes(dfa_alphabet_, false);
+		for(uint32_t state = 0; state < number_of_states_ && merged_classes.Size() < classes_.Size(); ++state)
+		{
+			const uint32_t* row = &transitions_[ static_cast<size_t>(state) * number_of_columns_ ];
+			merged_classes.Refine([this, row](unsigned char c) -> uint32_t { return row[ classes_.GetClasses()[ c ] ]; });
+		}
+
+		if(merged_classes.Size() < classes_.Size())
+		{
+			std::vector<char> representatives = merged_classes.GetRepresentatives();
+			TransitionTable merged_transitions(static_cast<size_t>(number_of_states_ + 1) * merged_classes.Size(), sink);
+			for(uint32_t state = 0; state <= number_of_states_; ++state)
+			{
+				for(ByteClasses::Class k = 1; k < merged_classes.Size(); ++k)
+				{
+					merged_transitions[ static_cast<size_t>(state) * merged_classes.Size() + k ] = 
+						transitions_[ static_cast<size_t>(state) * number_of_columns_ + GetColumn(representatives[ k - 1 ]) ];
+				}
+			}
+			transitions_.swap(merged_transitions);
+			classes_ = merged_classes;
+			number_of_columns_ = merged_classes.Size();
+		}
+		is_finalized_ = true;
+	}
+
 	void DFATransitionTable::PrintTransitions(std::ostream& output_stream) const
 	{
-		for(int from = 0; from < transitions_.size(); ++from)
+		for(uint32_t from = 0; from < number_of_states_; ++from)
 		{
-			for(auto on_to : transitions_[ from ])
+			for(char on : dfa_alphabet_.GetCharacters())
 			{
-				output_stream << from << ' ' << on_to.first << ' ' << on_to.second.GetValue() << std::endl;
+				State to = GetTransition(State(from), on);
+				if(to.IsInitialized())
+				{
+					output_stream << from << ' ' << on << ' ' << to.GetValue() << std::endl;
+				}
 			}
 		}
 	}
 
 	DirectedGraph DFATransitionTable::GetGraph() const
 	{
-		DirectedGraph G(transitions_.size());
-		for(int i = 0; i < G.size(); ++i)
+		std::vector<uint32_t> offsets(number_of_states_ + 1, 0);
+		std::vector<uint32_t> targets;
+		targets.reserve(static_cast<size_t>(number_of_states_) * (number_of_columns_ - 1));
+		// last_added[ v ] is the last state with an edge to v, so that parallel edges (on different classes) are added once
+		std::vector<uint32_t> last_added(number_of_states_ + 1, kNoTransition);
+		for(uint32_t from = 0; from < number_of_states_; ++from)
 		{
-			for(auto on_to : transitions_[ i ])
+			for(uint32_t column = 1; column < number_of_columns_; ++column)
 			{
-				G[i].insert(on_to.second.GetValue());
+				uint32_t to = GetData()[ static_cast<size_t>(from) * number_of_columns_ + column ];
+				if(to != kNoTransition && to != GetSinkState() && last_added[ to ] != from)
+				{
+					last_added[ to ] = from;
+					targets.push_back(to);
+				}
 			}
+			offsets[ from + 1 ] = targets.size();
 		}
 
-		return G;
+		return DirectedGraph(std::move(offsets), std::move(targets));
 	}
 
 	void swap(DFATransitionTable& a, DFATransitionTable& b) noexcept
 	{
 		using std::swap; 
 		swap(a.transitions_, b.transitions_);
+		swap(a.mapping_, b.mapping_);
+		swap(a.mapped_transitions_, b.mapped_transitions_);
+		swap(a.classes_, b.classes_);
+		swap(a.number_of_states_, b.number_of_states_);
+		swap(a.number_of_columns_, b.number_of_columns_);
+		swap(a.is_finalized_, b.is_finalized_);
 		swap(a.dfa_alphabet_, b.dfa_alphabet_);
 	}
 
@@ -75,6 +168,145 @@ namespace slarx
 		using std::swap;
 		swap(static_cast<Automaton&>(a), static_cast<Automaton&>(b));
 		swap(a.transition_table_, b.transition_table_);
+		swap(a.accepting_lookup_, b.accepting_lookup_);
+		swap(a.state_kinds_, b.state_kinds_);
+		swap(a.accelerations_, b.accelerations_);
+		swap(a.exit_lookups_, b.exit_lookups_);
+	}
+
+	void DFA::Finalize(std::vector<StateKind>&& state_kinds)
+	{
+		// The flat tables are indexed with these states directly, so states outside of the DFA are rejected up front
+		if(static_cast<uint32_t>(GetStartState().GetValue()) >= GetNumberOfStates())
+		{
+			throw std::invalid_argument("The start state of a DFA must be one of its states!");
+		}
+		for(State s : GetAcceptingStates())
+		{
+			if(static_cast<uint32_t>(s.GetValue()) >= GetNumberOfStates())
+			{
+				throw std::invalid_argument("The accepting states of a DFA must be among its states!");
+			}
+		}
+		transition_table_.Finalize();
+		accepting_lookup_.assign(GetNumberOfStates() + 1, 0);
+		for(State s : GetAcceptingStates())
+		{
+			accepting_lookup_[ s.GetValue() ] = 1;
+		}
+		if(state_kinds.empty())
+		{
+			ClassifyStates();
+		}
+		else
+		{
+			state_kinds_ = std::move(state_kinds);
+			AccelerateStates();
+		}
+	}
+
+	void DFA::ClassifyStates()
+	{
+		const uint32_t number_of_states = GetNumberOfStates();
+		const uint32_t sink = transition_table_.GetSinkState();
+		const uint32_t columns = transition_table_.GetNumberOfColumns();
+		DirectedGraph G = transition_table_.GetGraph();
+		// The graph leaves out the sink row, so the states with a transition to it are the ones, which can reach a rejecting row
+		std::vector<uint32_t> accepting_states;
+		std::vector<uint32_t> rejecting_states;
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			bool reaches_sink = !accepting_lookup_[ s ];
+			for(uint32_t k = 0; k < columns && !reaches_sink; ++k)
+			{
+				reaches_sink = transition_table_.GetClassTransition(s, k) == sink;
+			}
+			if(accepting_lookup_[ s ])
+			{
+				accepting_states.push_back(s);
+			}
+			if(reaches_sink)
+			{
+				rejecting_states.push_back(s);
+			}
+		}
+		std::vector<bool> can_accept = CoReachable(G, accepting_states);
+		std::vector<bool> can_reject = CoReachable(G, rejecting_states);
+
+		state_kinds_.assign(number_of_states + 1, StateKind::kNormal);
+		state_kinds_[ sink ] = StateKind::kDead;
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			if(!can_accept[ s ])
+			{
+				state_kinds_[ s ] = StateKind::kDead;
+			}
+			else if(!can_reject[ s ])
+			{
+				state_kinds_[ s ] = StateKind::kAcceptingSink;
+			}
+		}
+		AccelerateStates();
+	}
+
+	void DFA::AccelerateStates()
+	{
+		const uint32_t number_of_states = GetNumberOfStates();
+		const uint32_t columns = transition_table_.GetNumberOfColumns();
+		std::vector<uint32_t> class_sizes(columns, 0);
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			++class_sizes[ transition_table_.GetColumn(static_cast<char>(c)) ];
+		}
+		accelerations_.assign(number_of_states + 1, Acceleration());
+		exit_lookups_.clear();
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			if(state_kinds_[ s ] == StateKind::kDead || state_kinds_[ s ] == StateKind::kAcceptingSink)
+				continue;
+			state_kinds_[ s ] = StateKind::kNormal;
+
+			uint32_t number_of_exit_characters = 0;
+			uint32_t number_of_loop_characters = 0;
+			for(uint32_t k = 1; k < columns; ++k)
+			{
+				if(transition_table_.GetClassTransition(s, k) != s)
+				{
+					number_of_exit_characters += class_sizes[ k ];
+				}
+				else
+				{
+					number_of_loop_characters += class_sizes[ k ];
+				}
+			}
+			if(number_of_exit_characters > kMaxSearchedCharacters || number_of_loop_characters < kMinimalLoopCharacters)
+				continue;
+
+			std::array<uint8_t, 256> is_exit;
+			for(unsigned c = 0; c < 256; ++c)
+			{
+				is_exit[ c ] = transition_table_.GetClassTransition(s, transition_table_.GetColumn(static_cast<char>(c))) != s;
+			}
+			Acceleration& acceleration = accelerations_[ s ];
+			acceleration.number_of_exit_characters = 0;
+			// Characters outside of the alphabet are exits too, unless the alphabet has all characters
+			if(number_of_exit_characters + class_sizes[ 0 ] > kMaxSearchedCharacters)
+			{
+				acceleration.exit_lookup = static_cast<uint32_t>(exit_lookups_.size());
+				exit_lookups_.push_back(is_exit);
+			}
+			else
+			{
+				for(unsigned c = 0; c < 256; ++c)
+				{
+					if(is_exit[ c ])
+					{
+						acceleration.exit_characters[ acceleration.number_of_exit_characters++ ] = static_cast<char>(c);
+					}
+				}
+			}
+			state_kinds_[ s ] = StateKind::kAccelerated;
+		}
 	}
 
 	DFA::DFA(const std::string& path)
@@ -84,84 +316,58 @@ namespace slarx
 
 	bool DFA::ReadFromFile(const std::string& path)
 	{
-		std::ifstream input_file(path);
-		//std::stringstream buffer;
-		//buffer << input_file.rdbuf();
+		std::shared_ptr<const MappedFile> mapping = std::make_shared<const MappedFile>(path);
+		if(mapping->Size() >= sizeof(kBinaryDFAMagic) && std::equal(kBinaryDFAMagic, kBinaryDFAMagic + sizeof(kBinaryDFAMagic), mapping->GetData()))
+		{
+			return ReadBinary(std::move(mapping));
+		}
 
-		// TODO - add checks to account for different line endings (\n ,\r, \r\n)
-		std::string line;
-		getline(input_file, line);
-		if(line == Automaton::kDFAType())
+		AutomatonTextParser parser(mapping->GetData(), mapping->Size(), Automaton::kDFAType());
+		std::string type = parser.ReadType();
+		if(type == Automaton::kDFAType())
 		{
-			input_file.close();
-			ReadDFA(path);
+			ReadDFA(parser);
 		}
-		else if(line == Automaton::kUnspecifiedType() || line == Automaton::kNFAType() || line == Automaton::kEpsilonNFAType())
+		else if(type == Automaton::kUnspecifiedType() || type == Automaton::kNFAType() || type == Automaton::kEpsilonNFAType())
 		{
-			input_file.close();
-			ReadNFA(path);
+			ReadNFA(parser);
 		}
 		else
 		{
-			input_file.close();
 			throw std::invalid_argument("Invalid automaton type specified");
 		}
 
 		return true;
 	}
 
-	bool DFA::ReadDFA(const std::string& path)
+	bool DFA::ReadDFA(AutomatonTextParser& parser)
 	{
-		std::ifstream input_file(path);
-		if(input_file.fail())
-		{
-			throw(std::invalid_argument("Bad file specified for DFA read!"));
-			return false;
-		}
-		std::string line;
-
 		uint32_t number_of_states;
 		Alphabet alphabet;
 		State start_state;
 		std::set<State> accepting_states;
-		std::vector<int> integers;
 		
-		ReadAutomatonData(input_file, number_of_states, alphabet, start_state, accepting_states);
+		parser.ReadAutomatonData(number_of_states, alphabet, start_state, accepting_states);
 
-		// TODO - read transitions
 		DFATransitionTable transition_table(number_of_states, alphabet);
-		//transition_table.SetAlphabet(alphabet);
-		int line_number = 5;
-		while(getline(input_file, line))
+		const size_t first_transition_line = parser.GetLineNumber();
+		uint32_t from, to;
+		char on;
+		while(parser.ReadTransition(from, on, to))
 		{
-			std::vector<std::string> tokens = Tokenize(line, ' ');
-			if(tokens.size() == 3)
+			if(from < number_of_states && to < number_of_states)
 			{
-				unsigned from = IntegerParse(tokens[0])[0];
-				char on = tokens[1][0]; // TODO: this should check if tokens[1] is really a single character
-				unsigned to = IntegerParse(tokens[2])[0];
-				if(from >= 0 && from <= number_of_states && to >= 0 && to <= number_of_states)
-				{
-					transition_table.AddTransition(State(from), on, State(to));
-				}
-				else
-				{
-					std::stringstream error_message;
-					error_message << "Line " << line_number << " (transition of DFA) - transition contains an unexisting state!";
-					throw(std::invalid_argument(error_message.str()));
-				}
+				transition_table.AddTransition(State(from), on, State(to));
 			}
 			else
 			{
 				std::stringstream error_message;
-				error_message << "Line " << line_number << " (transition of DFA) contains too many or too few arguments! (should be 3)";
+				error_message << "Line " << parser.GetLineNumber() - 1 << " (transition of DFA) - transition contains an unexisting state!";
 				throw(std::invalid_argument(error_message.str()));
 			}
-
-			++line_number;
 		}
 
-		if(line_number - 5 != number_of_states * alphabet.Size())
+		if(static_cast<size_t>(parser.GetLineNumber()) - first_transition_line != number_of_states * alphabet.Size())
 		{
 			throw(std::invalid_argument("Too few transitions specified for a DFA! It should have a transition from every state on every character!"));
 		}
@@ -172,9 +378,104 @@ namespace slarx
 		return true;
 	}
 
-	bool DFA::ReadNFA(const std::string & path)
+	bool DFA::ReadBinary(std::shared_ptr<const MappedFile> mapping)
+	{
+		BinaryDFAHeader header;
+		if(mapping->Size() < sizeof(header))
+		{
+			throw std::invalid_argument("Binary DFA file is too short to contain a header.");
+		}
+		std::memcpy(&header, mapping->GetData(), sizeof(header));
+		if(header.version != BinaryDFAHeader::kVersion || header.byte_order_mark != BinaryDFAHeader::kByteOrderMark)
+		{
+			throw std::invalid_argument("Binary DFA file has an unsupported version or byte order.");
+		}
+
+		const size_t classes_offset = sizeof(header);
+		const size_t accepting_offset = classes_offset + 256 * sizeof(ByteClasses::Class);
+		const size_t accepting_words = (static_cast<size_t>(header.number_of_states) + 1 + 63) / 64;
+		const size_t kinds_offset = accepting_offset + accepting_words * sizeof(uint64_t);
+		const size_t kinds_size = (static_cast<size_t>(header.number_of_states) + 1 + 7) / 8 * 8;
+		const size_t table_offset = kinds_offset + kinds_size;
+		const size_t table_entries = (static_cast<size_t>(header.number_of_states) + 1) * header.number_of_columns;
+		if(header.number_of_columns == 0 || header.number_of_columns > 257 || header.start_state >= header.number_of_states 
+		   || mapping->Size() != table_offset + table_entries * sizeof(uint32_t))
+		{
+			throw std::invalid_argument("Binary DFA file is corrupted (its size does not match its header).");
+		}
+
+		std::array<ByteClasses::Class, 256> class_of;
+		std::memcpy(class_of.data(), mapping->GetData() + classes_offset, sizeof(class_of));
+		Alphabet alphabet;
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			if(class_of[ c ] >= header.number_of_columns)
+			{
+				throw std::invalid_argument("Binary DFA file is corrupted (invalid character class).");
+			}
+			if(class_of[ c ] != 0)
+			{
+				alphabet.AddCharacter(static_cast<char>(c));
+			}
+		}
+		ByteClasses classes(class_of);
+
+		// The table is used in place, but every row is indexed with its entries, so they are checked once. The sink row must lead
+		// to itself only
+		const uint32_t* transitions = reinterpret_cast<const uint32_t*>(mapping->GetData() + table_offset);
+		const size_t sink_row_offset = static_cast<size_t>(header.number_of_states) * header.number_of_columns;
+		for(size_t i = 0; i < table_entries; ++i)
+		{
+			if(transitions[ i ] > header.number_of_states || (i >= sink_row_offset && transitions[ i ] != header.number_of_states))
+			{
+				throw std::invalid_argument("Binary DFA file is corrupted (transition to an unexisting state).");
+			}
+		}
+
+		// The accepting states are the only part, which is not used in place. Empty words of the bitset are skipped
+		std::set<State> accepting_states;
+		for(size_t w = 0; w < accepting_words; ++w)
+		{
+			uint64_t word;
+			std::memcpy(&word, mapping->GetData() + accepting_offset + w * sizeof(uint64_t), sizeof(word));
+			for(; word != 0; word &= word - 1)
+			{
+				const size_t s = w * 64 + CountTrailingZeros(word);
+				if(s < header.number_of_states)
+				{
+					accepting_states.insert(accepting_states.end(), State(static_cast<uint32_t>(s)));
+				}
+			}
+		}
+
+		// Classifying the states takes a graph of the whole DFA, so their kinds are stored. Only the accelerations are set up again
+		std::vector<StateKind> state_kinds(header.number_of_states + 1);
+		std::memcpy(state_kinds.data(), mapping->GetData() + kinds_offset, state_kinds.size());
+		for(StateKind kind : state_kinds)
+		{
+			if(kind > StateKind::kAccelerated)
+			{
+				throw std::invalid_argument("Binary DFA file is corrupted (invalid state kind).");
+			}
+		}
+		if(state_kinds.back() != StateKind::kDead)
+		{
+			throw std::invalid_argument("Binary DFA file is corrupted (the sink row is not dead).");
+		}
+
+		uint32_t number_of_states = header.number_of_states;
+		State start_state(header.start_state);
+		DFATransitionTable transition_table(number_of_states, alphabet, classes, std::move(mapping), transitions);
+		*this = DFA(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states), std::move(transition_table),
+					std::move(state_kinds));
+		ReportAutomatonWasCreated();
+
+		return true;
+	}
+
+	bool DFA::ReadNFA(AutomatonTextParser& parser)
 	{
-		ConversionNFA conversion_nfa(path);
+		ConversionNFA conversion_nfa(parser);
 		(*this) = conversion_nfa.ToDFA();
 
 		return true;
@@ -200,21 +501,134 @@ namespace slarx
 		PrintTransitions(output_file);
 	}
 
+	void DFA::ExportBinary(const std::string& path) const
+	{
+		const DFATransitionTable& table = transition_table_;
+		BinaryDFAHeader header = { };
+		std::copy(kBinaryDFAMagic, kBinaryDFAMagic + sizeof(kBinaryDFAMagic), header.magic);
+		header.version = BinaryDFAHeader::kVersion;
+		header.byte_order_mark = BinaryDFAHeader::kByteOrderMark;
+		header.number_of_states = GetNumberOfStates();
+		header.number_of_columns = table.GetNumberOfColumns();
+		header.start_state = GetStartState().GetValue();
+
+		std::vector<uint64_t> accepting_bits((static_cast<size_t>(GetNumberOfStates()) + 1 + 63) / 64, 0);
+		for(State s : GetAcceptingStates())
+		{
+			accepting_bits[ s.GetValue() / 64 ] |= uint64_t(1) << (s.GetValue() % 64);
+		}
+
+		std::ofstream output_file(path, std::ios::binary);
+		output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output_file.write(reinterpret_cast<const char*>(table.GetByteClasses().GetClasses().data()), 256 * sizeof(ByteClasses::Class));
+		output_file.write(reinterpret_cast<const char*>(accepting_bits.data()), accepting_bits.size() * sizeof(uint64_t));
+		std::vector<StateKind> state_kinds(state_kinds_);
+		state_kinds.resize((state_kinds.size() + 7) / 8 * 8, StateKind::kNormal);
+		output_file.write(reinterpret_cast<const char*>(state_kinds.data()), state_kinds.size());
+		output_file.write(reinterpret_cast<const char*>(table.GetData()), (static_cast<size_t>(GetNumberOfStates()) + 1) * table.GetNumberOfColumns() * sizeof(uint32_t));
+	}
+
 	bool DFA::Recognize(std::string & word) const
 	{
-		State current_state = GetStartState();
-		for(char c : word)
+		return Recognize(word.data(), word.size());
+	}
+
+	uint32_t DFA::Advance(uint32_t state, const char* data, size_t size) const
+	{
+		const uint32_t* table = transition_table_.GetData();
+		const ByteClasses::Class* column_of = transition_table_.GetByteClasses().GetClasses().data();
+		const size_t width = transition_table_.GetNumberOfColumns();
+		const char* end = data + size;
+		while(true)
 		{
-			if(GetAlphabet().Contains(c))
+			for(; data != end && state_kinds_[ state ] == StateKind::kNormal; ++data)
 			{
-				current_state = transition_table_.GetTransition(current_state, c);
+				state = table[ state * width + column_of[ static_cast<unsigned char>(*data) ] ];
+			}
+			if(data == end)
+				break;
+
+			switch(state_kinds_[ state ])
+			{
+				case StateKind::kDead:
+				case StateKind::kAcceptingSink:
+					return state;
+				default:
+				{
+					const Acceleration& acceleration = accelerations_[ state ];
+					if(acceleration.number_of_exit_characters != 0)
+					{
+						data = FindAnyOf(data, end, acceleration.exit_characters, acceleration.number_of_exit_characters);
+					}
+					else
+					{
+						data = FindAnyOf(data, end, exit_lookups_[ acceleration.exit_lookup ]);
+					}
+					if(data == end)
+						break;
+					state = table[ state * width + column_of[ static_cast<unsigned char>(*data) ] ];
+					++data;
+					break;
+				}
+			}
+		}
+
+		return state;
+	}
+
+	void DFA::RecognizeBatch(const std::string_view* words, size_t count, uint64_t* results, unsigned number_of_threads) const
+	{
+		// Ranges are whole result words, so no two threads write to the same word
+		const size_t kWordsPerRange = 64 * 64;
+		const size_t table_size = (static_cast<size_t>(GetNumberOfStates()) + 1) * transition_table_.GetNumberOfColumns() * sizeof(uint32_t);
+		const bool interleave = table_size >= kMinimalInterleavedTableSize;
+		ParallelFor(count, kWordsPerRange, number_of_threads, [&](size_t begin, size_t end)
+		{
+			std::vector<uint32_t> final_states(end - begin);
+			if(interleave)
+			{
+				InterleavedRun(transition_table_, GetStartState().GetValue(), words + begin, end - begin, final_states.data());
 			}
 			else
 			{
-				return false;
+				for(size_t j = begin; j < end; ++j)
+				{
+					final_states[ j - begin ] = transition_table_.Run(GetStartState().GetValue(), words[ j ].data(), words[ j ].data() + words[ j ].size());
+				}
+			}
+			for(size_t i = begin; i < end; i += 64)
+			{
+				uint64_t result_bits = 0;
+				for(size_t j = i; j < std::min(end, i + 64); ++j)
+				{
+					result_bits |= uint64_t(accepting_lookup_[ final_states[ j - begin ] ]) << (j - i);
+				}
+				results[ i / 64 ] = result_bits;
+			}
+		});
+	}
+
+	std::vector<uint64_t> DFA::RecognizeBatch(const std::vector<std::string_view>& words, unsigned number_of_threads) const
+	{
+		std::vector<uint64_t> results((words.size() + 63) / 64);
+		RecognizeBatch(words.data(), words.size(), results.data(), number_of_threads);
+		return results;
+	}
+
+	void DFA::Complement()
+	{
+		// Every DFA is complete over its alphabet, so only the sink row, which handles characters outside of the alphabet, keeps rejecting
+		std::set<State> complement_accepting_states;
+		for(uint32_t s = 0; s < GetNumberOfStates(); ++s)
+		{
+			accepting_lookup_[ s ] = !accepting_lookup_[ s ];
+			if(accepting_lookup_[ s ])
+			{
+				complement_accepting_states.insert(State(s));
 			}
 		}
-		return IsAccepting(current_state);
+		SetAcceptingStates(std::move(complement_accepting_states));
+		ClassifyStates();
 	}
 
 	// Returns false if any accepting state is reachable from the start state and true otherwise
@@ -228,5 +642,109 @@ namespace slarx
 		return IsLanguageInfinite_AUX(transition_table_.GetGraph(), GetStartState(), GetAcceptingStates());
 	}
 
+	std::bitset<256> DFA::ComputeFirstCharacters() const
+	{
+		std::vector<uint32_t> final_states;
+		for(State s : GetAcceptingStates())
+		{
+			final_states.push_back(s.GetValue());
+		}
+		std::vector<bool> can_accept = CoReachable(transition_table_.GetGraph(), final_states);
+		can_accept.push_back(false);
+
+		std::bitset<256> first_characters;
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			if(can_accept[ transition_table_.GetClassTransition(GetStartState().GetValue(), transition_table_.GetColumn(static_cast<char>(c))) ])
+			{
+				first_characters.set(c);
+			}
+		}
+		return first_characters;
+	}
+
+	std::string DFA::ComputeRequiredSubstring() const
+	{
+		const uint32_t number_of_states = transition_table_.GetSinkState();
+		const uint32_t start = GetStartState().GetValue();
+		DirectedGraph G = transition_table_.GetGraph();
+		std::vector<uint32_t> final_states;
+		for(State s : GetAcceptingStates())
+		{
+			final_states.push_back(s.GetValue());
+		}
+		std::vector<bool> useful = Reachable(G, start);
+		std::vector<bool> co_reachable = CoReachable(G, final_states);
+		for(uint32_t u = 0; u < number_of_states; ++u)
+		{
+			useful[ u ] = useful[ u ] && co_reachable[ u ];
+		}
+		if(!useful[ start ])
+			return std::string();
+
+		// The graph of the useful states with an extra vertex, to which all accepting states lead. The states, which
+		// dominate the extra vertex, are visited by every accepted word, in the order of the dominator tree
+		const uint32_t end_vertex = number_of_states;
+		std::vector<uint32_t> offsets(number_of_states + 2, 0);
+		std::vector<uint32_t> targets;
+		std::vector<uint32_t> number_of_predecessors(number_of_states + 1, 0);
+		for(uint32_t u = 0; u < number_of_states; ++u)
+		{
+			for(uint32_t v : G[ u ])
+			{
+				if(useful[ u ] && useful[ v ])
+				{
+					targets.push_back(v);
+					++number_of_predecessors[ v ];
+				}
+			}
+			if(useful[ u ] && accepting_lookup_[ u ])
+			{
+				targets.push_back(end_vertex);
+			}
+			offsets[ u + 1 ] = targets.size();
+		}
+		offsets[ end_vertex + 1 ] = targets.size();
+		std::vector<uint32_t> dominator = ImmediateDominators(DirectedGraph(std::move(offsets), std::move(targets)), start);
+		std::vector<uint32_t> chain;
+		for(uint32_t v = dominator[ end_vertex ]; v != start; v = dominator[ v ])
+		{
+			chain.push_back(v);
+		}
+		chain.push_back(start);
+		std::reverse(chain.begin(), chain.end());
+
+		// If the only way into the next dominator is a single character from the previous one, the character is read right after
+		// the previous dominator is left for the last time, so runs of such steps spell strings, which every word contains
+		std::string longest;
+		std::string current;
+		for(size_t i = 0; i + 1 < chain.size(); ++i)
+		{
+			char only_character = 0;
+			unsigned number_of_characters = 0;
+			for(unsigned c = 0; c < 256 && number_of_predecessors[ chain[ i + 1 ] ] == 1; ++c)
+			{
+				if(transition_table_.GetClassTransition(chain[ i ], transition_table_.GetColumn(static_cast<char>(c))) == chain[ i + 1 ])
+				{
+					only_character = static_cast<char>(c);
+					++number_of_characters;
+				}
+			}
+			if(number_of_characters == 1)
+			{
+				current.push_back(only_character);
+				if(current.size() > longest.size())
+				{
+					longest = current;
+				}
+			}
+			else
+			{
+				current.clear();
+			}
+		}
+		return longest;
+	}
+
 }
 
@@ -4,6 +4,7 @@
 
 #include "automaton.h"
 #include "graph.h"
+#include "utility.h"
 
 #include <unordered_map>
 #include <set>
@@ -11,17 +12,33 @@
 #include <algorithm>
 #include <memory>
 #include <map>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <bitset>
+#include <string>
 
 namespace slarx
 {
 	class DFATransitionTable
 	{
 	public:
-		typedef std::vector<std::map<char, State> > TransitionTable;
-		DFATransitionTable() = default;
-		DFATransitionTable(unsigned dfa_number_of_states, Alphabet& dfa_alphabet) : transitions_(dfa_number_of_states), dfa_alphabet_(dfa_alphabet) { }
-		DFATransitionTable(const DFATransitionTable& other) : transitions_(other.transitions_), dfa_alphabet_(other.dfa_alphabet_) { }
-		DFATransitionTable(DFATransitionTable&& other) { swap(*this, other); }
+		// Marks a transition, which has not been added yet
+		static const uint32_t kNoTransition = UINT32_MAX;
+		// Transitions are kept in a contiguous row-major table with one row per state and one column per class of characters
+		// (see ByteClasses). Column 0 is the class of characters outside of the alphabet
+		typedef std::vector<uint32_t> TransitionTable;
+		DFATransitionTable() : mapped_transitions_(nullptr), number_of_states_(0), number_of_columns_(1), is_finalized_(false) { }
+		// Creates a table with a column for every character of the alphabet
+		DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet);
+		// Creates a table with a column for every class of classes. Adding a transition on a character adds it for its whole class
+		DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet, const ByteClasses& classes);
+		// Creates a finalized table, which reads its transitions directly from a mapped file. transitions must point to
+		// (dfa_number_of_states + 1) * classes.Size() entries inside of mapping, including the sink row
+		DFATransitionTable(unsigned dfa_number_of_states, const Alphabet& dfa_alphabet, const ByteClasses& classes,
+						   std::shared_ptr<const MappedFile> mapping, const uint32_t* transitions);
+		DFATransitionTable(const DFATransitionTable& other) = default;
+		DFATransitionTable(DFATransitionTable&& other) : DFATransitionTable() { swap(*this, other); }
 		DFATransitionTable& operator=(DFATransitionTable other){ swap(*this, other); return *this; }
 		~DFATransitionTable() = default;
 
@@ -30,30 +47,93 @@ namespace slarx
 		const State GetTransition(State from, char on) const;
 		// Returns a graph representation of the transition function (disregarding the characters used for transitions)
 		DirectedGraph GetGraph() const;
-		// Each DFATransition table should be associated with a single DFA, thus the unique_ptr
-		void SetAlphabet(const Alphabet& alphabet) { dfa_alphabet_ = alphabet; }
-		void SetNumberOfStates(unsigned dfa_number_of_states){ transitions_.resize(dfa_number_of_states); }
+		void SetNumberOfStates(unsigned dfa_number_of_states);
 		// Prints all transitions of the DFA formatted one transition on each line, starting with all transitions of state 0, then state 1, etc...
 		void PrintTransitions(std::ostream& output_stream) const;
-		const TransitionTable& GetTransitions() const { return transitions_; }
+		// Returns the row-major transition table, which is either owned by the table or mapped from a file
+		const uint32_t* GetData() const { return mapping_ ? mapped_transitions_ : transitions_.data(); }
+
+		// Appends a sink row (with index equal to the number of states), to which every missing transition and
+		// every character outside of the alphabet lead, and merges the columns of characters with identical
+		// transitions into a single class. Should be called once, after all transitions are added
+		void Finalize();
+		bool IsFinalized() const { return is_finalized_; }
+		uint32_t GetNumberOfColumns() const { return number_of_columns_; }
+		uint32_t GetColumn(char c) const { return classes_.Get(c); }
+		const ByteClasses& GetByteClasses() const { return classes_; }
+		// Returns the target of the transition from state on a class of characters. Valid only for a finalized table
+		uint32_t GetClassTransition(uint32_t state, ByteClasses::Class on) const { return GetData()[ static_cast<size_t>(state) * number_of_columns_ + on ]; }
+		// Sets the transition from state on a class of characters, replacing the previous one. Valid only before the table is finalized
+		void SetClassTransition(uint32_t state, ByteClasses::Class on, uint32_t to) { transitions_[ static_cast<size_t>(state) * number_of_columns_ + on ] = to; }
+		uint32_t GetSinkState() const { return number_of_states_; }
+		// Runs the finalized table on [begin, end) starting from state. Returns the reached row, which is the sink row if the word left the alphabet
+		uint32_t Run(uint32_t state, const char* begin, const char* end) const
+		{
+			const uint32_t* table = GetData();
+			const ByteClasses::Class* column_of = classes_.GetClasses().data();
+			const size_t width = number_of_columns_;
+			for(; begin != end; ++begin)
+			{
+				state = table[ state * width + column_of[ static_cast<unsigned char>(*begin) ] ];
+			}
+			return state;
+		}
 
 		friend void swap(DFATransitionTable& a, DFATransitionTable& b) noexcept;
 	private:
 		TransitionTable transitions_;
+		// Set instead of transitions_ for tables loaded from a binary file
+		std::shared_ptr<const MappedFile> mapping_;
+		const uint32_t* mapped_transitions_;
+		// Maps every byte to its column in transitions_
+		ByteClasses classes_;
+		uint32_t number_of_states_;
+		uint32_t number_of_columns_;
+		bool is_finalized_;
 		Alphabet dfa_alphabet_;
 	};
 
+	struct BinaryDFAHeader
+	{
+		static constexpr uint32_t kVersion = 2;
+		// Written as 0x01020304, so that files with a different byte order are rejected
+		static constexpr uint32_t kByteOrderMark = 0x01020304;
+		char magic[ 8 ];
+		uint32_t version;
+		uint32_t byte_order_mark;
+		uint32_t number_of_states;
+		uint32_t number_of_columns;
+		uint32_t start_state;
+		uint32_t reserved;
+	};
+	// Identifies binary DFA files
+	const char kBinaryDFAMagic[ 8 ] = { 'S', 'L', 'A', 'R', 'X', 'D', 'F', 'A' };
+
 	class DFA : public Automaton
 	{
 	public:
+		// Kinds of rows of the transition table, in which Recognize does not have to follow every transition
+		enum class StateKind : uint8_t
+		{
+			kNormal,
+			// No accepting state is reachable (e.g. the sink row)
+			kDead,
+			// Only accepting states are reachable
+			kAcceptingSink,
+			// Loops to itself on all but at most kMaxSearchedCharacters characters of the alphabet (and at least kMinimalLoopCharacters),
+			// so the input is searched for the other characters with FindAnyOf
+			kAccelerated
+		};
+
 		// Reads a DFA from a file located at path
 		DFA(const std::string& path);
-		DFA(const DFA& other) : Automaton(other), transition_table_(other.transition_table_) { }
+		DFA(const DFA& other) : Automaton(other), transition_table_(other.transition_table_), accepting_lookup_(other.accepting_lookup_),
+			state_kinds_(other.state_kinds_), accelerations_(other.accelerations_), exit_lookups_(other.exit_lookups_) { }
 		// Constructor which "cannibalizes" its arguments. Should be used when reading a DFA to ensure that there is sufficient memory before assigning any members.
 		DFA(uint32_t&& number_of_states, Alphabet&& alphabet, State&& start_state, 
 			std::set<State>&& accepting_states, DFATransitionTable&& transition_table, bool report_automaton_was_created) :
-			Automaton(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states)), transition_table_(transition_table) 
-		{ if(report_automaton_was_created) ReportAutomatonWasCreated(); }
+			Automaton(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states)), transition_table_(std::move(transition_table)) 
+		{ Finalize(); if(report_automaton_was_created) ReportAutomatonWasCreated(); }
 		
 		DFA(DFA&& other, bool report_automaton_was_created) { swap(*this, other); if(report_automaton_was_created) ReportAutomatonWasCreated(); }
 		DFA& operator=(DFA other){ swap(*this, other); return *this; }
@@ -68,23 +148,82 @@ namespace slarx
 		virtual void PrintTransitions(std::ostream& output_stream) const override;
 		// Exports the Automaton to a .at file at location path
 		virtual void Export(const std::string& path) const override;
+		// Exports the DFA in the binary format, which ReadFromFile recognizes by its header and maps into memory without parsing.
+		// The format is a BinaryDFAHeader, followed by the 256 byte classes (uint16), the accepting state bitset (uint64 words,
+		// with a bit for the sink row), the kinds of the rows (uint8, padded to a multiple of 8 bytes) and the finalized row-major
+		// transition table (uint32), all in native byte order. Loading still takes a pass over the table, whose entries are checked
+		// and whose accelerated states are set up, and builds the set of accepting states
+		void ExportBinary(const std::string& path) const;
 
 		// Returns true if word is in the automaton's language and false otherwise
 		virtual bool Recognize(std::string& word) const override;
+		bool Recognize(const char* data, size_t size) const { return accepting_lookup_[ Advance(GetStartState().GetValue(), data, size) ] != 0; }
+		// Runs the DFA on [data, data + size) starting from a row of the transition table and returns the reached row. Stops as soon
+		// as a dead state or an accepting sink is reached, returning that row instead, since the rest of the input can not change
+		// whether the word is accepted. Skips ahead with FindAnyOf in accelerated states
+		uint32_t Advance(uint32_t state, const char* data, size_t size) const;
+		// Recognizes count words and sets bit i of results (a bitmap of (count + 63) / 64 words) if words[ i ] is in the language.
+		// The words are split across number_of_threads threads (0 uses all hardware threads), which share the read-only DFA. For
+		// tables too large for the caches, several words are advanced at a time with InterleavedRun
+		void RecognizeBatch(const std::string_view* words, size_t count, uint64_t* results, unsigned number_of_threads = 0) const;
+		std::vector<uint64_t> RecognizeBatch(const std::vector<std::string_view>& words, unsigned number_of_threads = 0) const;
 		// Answers questions about the properties of the language the Automaton describes
 		virtual bool IsLanguageEmpty() const override;
 		virtual bool IsLanguageInfinite() const override;
+		// Returns the set of characters, with which the nonempty words of the language start
+		std::bitset<256> ComputeFirstCharacters() const;
+		// Returns a string, which every word of the language contains, or an empty string if none is found. The string is read off
+		// the states, which dominate all accepting states, where consecutive dominators are connected by a single character only
+		std::string ComputeRequiredSubstring() const;
+
+		// Replaces the language of the DFA with its complement relative to all words over its alphabet
+		void Complement();
 
 		const DFATransitionTable& GetTransitionTable() const { return transition_table_; }
+		// Returns a lookup with an entry for every row of the transition table (including the sink row), which is 1 for accepting states
+		const std::vector<uint8_t>& GetAcceptingLookup() const { return accepting_lookup_; }
+		// Returns the kind of a row of the transition table (including the sink row)
+		StateKind GetStateKind(uint32_t state) const { return state_kinds_[ state ]; }
 		friend void swap(DFA& a, DFA& b) noexcept;
 
 	private:
-		// Helper funtion for ReadFromFile. Reads a know DFA directly
-		bool ReadDFA(const std::string& path);
+		// Helper funtion for ReadFromFile. Reads a know DFA directly. The parser must be past the type specifier
+		bool ReadDFA(AutomatonTextParser& parser);
 		// Helper funtion for ReadFromFile. Read an unknown Automaton type or NFA and converts it to a DFA
-		bool ReadNFA(const std::string& path);
+		bool ReadNFA(AutomatonTextParser& parser);
+		// Helper funtion for ReadFromFile. Uses a mapped DFA exported with ExportBinary. Throws std::invalid_argument if the file
+		// is corrupted, including transitions to unexisting states
+		bool ReadBinary(std::shared_ptr<const MappedFile> mapping);
 		State Transition(State from, char on) const { return transition_table_.GetTransition(from, on); }
+		// Used by ReadBinary, which has the kinds of the states from the file instead of classifying them
+		DFA(uint32_t&& number_of_states, Alphabet&& alphabet, State&& start_state, std::set<State>&& accepting_states,
+			DFATransitionTable&& transition_table, std::vector<StateKind>&& state_kinds) :
+			Automaton(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states)), transition_table_(std::move(transition_table))
+		{ Finalize(std::move(state_kinds)); }
+		// Builds the flat transition table and the accepting state lookup. Called once the DFA is complete. The states are classified
+		// unless their kinds are given
+		void Finalize(std::vector<StateKind>&& state_kinds = std::vector<StateKind>());
 		DFATransitionTable transition_table_;
+		// Sets state_kinds_ and accelerations_. Called whenever the transitions or the accepting states change
+		void ClassifyStates();
+		// Sets accelerations_ and decides, which of the states, that are neither dead nor accepting sinks, are accelerated
+		void AccelerateStates();
+		// accepting_lookup_[s] is 1 if s is an accepting state. Has an entry for the sink row of the transition table
+		std::vector<uint8_t> accepting_lookup_;
+		// Searching for the exits of a state pays off only if it loops on enough characters
+		static const unsigned kMinimalLoopCharacters = 8;
+		// The characters, on which an accelerated state leaves itself. Up to kMaxSearchedCharacters of them are listed,
+		// otherwise (e.g. when characters outside of the alphabet are among them) they are marked in exit_lookups_[ exit_lookup ]
+		struct Acceleration
+		{
+			uint32_t exit_lookup;
+			uint8_t number_of_exit_characters;
+			char exit_characters[ kMaxSearchedCharacters ];
+		};
+		// Both have an entry for every row of the transition table. accelerations_[ s ] is used only if s is accelerated
+		std::vector<StateKind> state_kinds_;
+		std::vector<Acceleration> accelerations_;
+		std::vector<std::array<uint8_t, 256> > exit_lookups_;
 	};
 }
 
@@ -0,0 +1,241 @@
+#include "dfa_minimization.h"
+
+#include <vector>
+#include <queue>
+#include <utility>
+
+namespace slarx
+{
+	namespace
+	{
+		// Partition of the states 0..n-1 into blocks. The states of a block occupy a contiguous range of elements_,
+		// and marked states are moved to the front of their block's range, so that splitting a block takes time
+		// proportional to the number of marked states
+		class Partition
+		{
+		public:
+			explicit Partition(uint32_t number_of_states) : elements_(number_of_states), location_(number_of_states), block_of_(number_of_states, 0)
+			{
+				for(uint32_t s = 0; s < number_of_states; ++s)
+				{
+					elements_[ s ] = s;
+					location_[ s ] = s;
+				}
+				first_.push_back(0);
+				end_.push_back(number_of_states);
+				marked_.push_back(0);
+			}
+
+			uint32_t GetNumberOfBlocks() const { return first_.size(); }
+			uint32_t GetBlock(uint32_t state) const { return block_of_[ state ]; }
+			uint32_t GetBlockSize(uint32_t block) const { return end_[ block ] - first_[ block ]; }
+			const uint32_t* BlockBegin(uint32_t block) const { return &elements_[ first_[ block ] ]; }
+			const uint32_t* BlockEnd(uint32_t block) const { return elements_.data() + end_[ block ]; }
+
+			void Mark(uint32_t state)
+			{
+				uint32_t block = block_of_[ state ];
+				uint32_t position = first_[ block ] + marked_[ block ];
+				if(location_[ state ] < position)
+					return; // Already marked
+				if(marked_[ block ] == 0)
+					touched_.push_back(block);
+				std::swap(elements_[ location_[ state ] ], elements_[ position ]);
+				location_[ elements_[ location_[ state ] ] ] = location_[ state ];
+				location_[ state ] = position;
+				++marked_[ block ];
+			}
+
+			// Splits every block with marked states into its marked and unmarked part. Calls on_split(old_block, new_block)
+			// for every split, where new_block is the part with the marked states
+			template<typename Function>
+			void SplitMarked(Function on_split)
+			{
+				for(uint32_t block : touched_)
+				{
+					uint32_t marked = marked_[ block ];
+					marked_[ block ] = 0;
+					if(marked == GetBlockSize(block))
+						continue;
+
+					uint32_t new_block = first_.size();
+					first_.push_back(first_[ block ]);
+					end_.push_back(first_[ block ] + marked);
+					marked_.push_back(0);
+					first_[ block ] += marked;
+					for(uint32_t i = first_[ new_block ]; i < end_[ new_block ]; ++i)
+					{
+						block_of_[ elements_[ i ] ] = new_block;
+					}
+					on_split(block, new_block);
+				}
+				touched_.clear();
+			}
+
+			// Moves every state s, for which in_second_block(s) is true, to a new block. Used to build the initial partition
+			template<typename Predicate>
+			void SplitBy(Predicate in_second_block)
+			{
+				for(uint32_t s = 0; s < elements_.size(); ++s)
+				{
+					if(in_second_block(s))
+						Mark(s);
+				}
+				SplitMarked([](uint32_t, uint32_t) { });
+			}
+
+		private:
+			std::vector<uint32_t> elements_;
+			std::vector<uint32_t> location_;
+			std::vector<uint32_t> block_of_;
+			std::vector<uint32_t> first_;
+			std::vector<uint32_t> end_;
+			std::vector<uint32_t> marked_;
+			std::vector<uint32_t> touched_;
+		};
+	}
+
+	DFA MinimizeDFA(const DFA& dfa)
+	{
+		const DFATransitionTable& table = dfa.GetTransitionTable();
+		const uint32_t columns = table.GetNumberOfColumns();
+
+		// Only the states reachable from the start state take part in the minimization. They are renumbered in BFS order.
+		// The sink row of the table becomes an ordinary error state if a missing transition reaches it
+		std::vector<uint32_t> reachable_index(dfa.Size() + 1, DFATransitionTable::kNoTransition);
+		std::vector<uint32_t> reachable;
+		reachable_index[ dfa.GetStartState().GetValue() ] = 0;
+		reachable.push_back(dfa.GetStartState().GetValue());
+		for(uint32_t i = 0; i < reachable.size(); ++i)
+		{
+			for(ByteClasses::Class k = 1; k < columns; ++k)
+			{
+				uint32_t to = table.GetClassTransition(reachable[ i ], k);
+				if(reachable_index[ to ] == DFATransitionTable::kNoTransition)
+				{
+					reachable_index[ to ] = reachable.size();
+					reachable.push_back(to);
+				}
+			}
+		}
+		const uint32_t n = reachable.size();
+
+		// Inverse transitions for every class, stored contiguously: the predecessors of s on class k are
+		// predecessors[ predecessors_first[ k * (n + 1) + s ] .. predecessors_first[ k * (n + 1) + s + 1 ] )
+		std::vector<uint32_t> predecessors_first(static_cast<size_t>(columns) * (n + 1), 0);
+		std::vector<uint32_t> predecessors(static_cast<size_t>(n) * (columns - 1));
+		for(uint32_t s = 0; s < n; ++s)
+		{
+			for(ByteClasses::Class k = 1; k < columns; ++k)
+			{
+				++predecessors_first[ static_cast<size_t>(k) * (n + 1) + reachable_index[ table.GetClassTransition(reachable[ s ], k) ] + 1 ];
+			}
+		}
+		size_t total = 0;
+		for(size_t i = 0; i < predecessors_first.size(); ++i)
+		{
+			total += predecessors_first[ i ];
+			predecessors_first[ i ] = total;
+		}
+		std::vector<uint32_t> fill(predecessors_first.begin(), predecessors_first.end());
+		for(uint32_t s = 0; s < n; ++s)
+		{
+			for(ByteClasses::Class k = 1; k < columns; ++k)
+			{
+				uint32_t to = reachable_index[ table.GetClassTransition(reachable[ s ], k) ];
+				predecessors[ fill[ static_cast<size_t>(k) * (n + 1) + to ]++ ] = s;
+			}
+		}
+
+		Partition partition(n);
+		partition.SplitBy([&](uint32_t s) { return dfa.IsAccepting(State(reachable[ s ])); });
+
+		// Hopcroft's algorithm: (block, class) splitters waiting to be processed. When a block in the worklist is split,
+		// both halves must be processed, otherwise only the smaller half is needed
+		std::vector<std::pair<uint32_t, ByteClasses::Class> > worklist;
+		std::vector<bool> in_worklist;
+		auto add_splitter = [&](uint32_t block, ByteClasses::Class k)
+		{
+			size_t index = static_cast<size_t>(block) * columns + k;
+			if(in_worklist.size() <= index)
+				in_worklist.resize(static_cast<size_t>(partition.GetNumberOfBlocks()) * columns, false);
+			if(!in_worklist[ index ])
+			{
+				in_worklist[ index ] = true;
+				worklist.push_back(std::make_pair(block, k));
+			}
+		};
+		uint32_t smaller_initial_block = (partition.GetNumberOfBlocks() == 2 && partition.GetBlockSize(1) < partition.GetBlockSize(0)) ? 1 : 0;
+		for(ByteClasses::Class k = 1; k < columns; ++k)
+		{
+			add_splitter(smaller_initial_block, k);
+		}
+
+		std::vector<uint32_t> splitter_states;
+		while(!worklist.empty())
+		{
+			uint32_t splitter = worklist.back().first;
+			ByteClasses::Class k = worklist.back().second;
+			worklist.pop_back();
+			in_worklist[ static_cast<size_t>(splitter) * columns + k ] = false;
+
+			splitter_states.assign(partition.BlockBegin(splitter), partition.BlockEnd(splitter));
+			for(uint32_t s : splitter_states)
+			{
+				const size_t offset = static_cast<size_t>(k) * (n + 1) + s;
+				for(uint32_t i = predecessors_first[ offset ]; i < predecessors_first[ offset + 1 ]; ++i)
+				{
+					partition.Mark(predecessors[ i ]);
+				}
+			}
+			partition.SplitMarked([&](uint32_t old_block, uint32_t new_block)
+			{
+				for(ByteClasses::Class c = 1; c < columns; ++c)
+				{
+					size_t old_index = static_cast<size_t>(old_block) * columns + c;
+					if(old_index < in_worklist.size() && in_worklist[ old_index ])
+					{
+						add_splitter(new_block, c);
+					}
+					else
+					{
+						add_splitter(partition.GetBlockSize(new_block) < partition.GetBlockSize(old_block) ? new_block : old_block, c);
+					}
+				}
+			});
+		}
+
+		// Every block becomes a state of the minimal DFA. States are numbered in BFS order from the start state
+		std::vector<uint32_t> block_index(partition.GetNumberOfBlocks(), DFATransitionTable::kNoTransition);
+		std::vector<uint32_t> block_order;
+		block_index[ partition.GetBlock(0) ] = 0;
+		block_order.push_back(partition.GetBlock(0));
+		Alphabet alphabet = dfa.GetAlphabet();
+		std::vector<char> class_representatives = table.GetByteClasses().GetRepresentatives();
+		DFATransitionTable minimal_transition_table(partition.GetNumberOfBlocks(), alphabet, table.GetByteClasses());
+		std::set<State> minimal_accepting_states;
+		for(uint32_t i = 0; i < block_order.size(); ++i)
+		{
+			uint32_t s = *partition.BlockBegin(block_order[ i ]);
+			if(dfa.IsAccepting(State(reachable[ s ])))
+			{
+				minimal_accepting_states.insert(State(i));
+			}
+			for(ByteClasses::Class k = 1; k < columns; ++k)
+			{
+				uint32_t to_block = partition.GetBlock(reachable_index[ table.GetClassTransition(reachable[ s ], k) ]);
+				if(block_index[ to_block ] == DFATransitionTable::kNoTransition)
+				{
+					block_index[ to_block ] = block_order.size();
+					block_order.push_back(to_block);
+				}
+				minimal_transition_table.AddTransition(State(i), class_representatives[ k - 1 ], State(block_index[ to_block ]));
+			}
+		}
+
+		uint32_t minimal_number_of_states = block_order.size();
+		State minimal_start_state(0);
+		return DFA(std::move(minimal_number_of_states), std::move(alphabet), std::move(minimal_start_state),
+				   std::move(minimal_accepting_states), std::move(minimal_transition_table), true);
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+#ifndef SLARX_DFA_MINIMIZATION_H_INCLUDED
+#define SLARX_DFA_MINIMIZATION_H_INCLUDED
+
+#include "dfa.h"
+
+namespace slarx
+{
+	// Produces the minimal DFA, which recognizes the same language as dfa. Unreachable states are removed and
+	// equivalent states are merged using Hopcroft's partition refinement, which runs in O(n * |classes| * log n)
+	DFA MinimizeDFA(const DFA& dfa);
+}
+
+#endif // SLARX_DFA_MINIMIZATION_H_INCLUDED
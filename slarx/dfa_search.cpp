@@ -0,0 +1,422 @@
+#include "dfa_search.h"
+#include "graph.h"
+
+#include <algorithm>
+
+namespace slarx
+{
+	const size_t DFASearcher::kDefaultCacheSize;
+	const uint32_t DFASearcher::kUnknownTransition;
+	const uint32_t DFASearcher::kEndOfGroup;
+	const uint8_t DFASearcher::kMatchEnds;
+	const uint8_t DFASearcher::kNoRunsLeft;
+
+	namespace
+	{
+		const size_t kNoMatch = SIZE_MAX;
+	}
+
+	DFASearcher::DFASearcher(const DFA& dfa, MatchKind kind, size_t cache_size)
+		: kind_(kind), table_(dfa.GetTransitionTable()), start_state_(dfa.GetStartState().GetValue()), accepting_lookup_(dfa.GetAcceptingLookup()),
+		prefilter_(dfa), number_of_flushes_(0), epoch_(0)
+	{
+		const uint32_t number_of_states = table_.GetSinkState();
+		const uint32_t columns = table_.GetNumberOfColumns();
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			if(accepting_lookup_[ s ])
+			{
+				accepting_states_.push_back(s);
+			}
+		}
+		// Runs in states, from which no accepting state is reachable, can never match, so they are dropped
+		std::vector<bool> can_accept = CoReachable(table_.GetGraph(), accepting_states_);
+		live_.assign(number_of_states + 1, 0);
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			live_[ s ] = can_accept[ s ];
+		}
+
+		reverse_offsets_.assign((static_cast<size_t>(number_of_states) + 1) * columns + 1, 0);
+		for(uint32_t from = 0; from < number_of_states; ++from)
+		{
+			for(uint32_t k = 0; live_[ from ] && k < columns; ++k)
+			{
+				const uint32_t to = table_.GetClassTransition(from, k);
+				if(live_[ to ])
+				{
+					++reverse_offsets_[ static_cast<size_t>(to) * columns + k + 1 ];
+				}
+			}
+		}
+		for(size_t i = 1; i < reverse_offsets_.size(); ++i)
+		{
+			reverse_offsets_[ i ] += reverse_offsets_[ i - 1 ];
+		}
+		reverse_targets_.resize(reverse_offsets_.back());
+		std::vector<uint32_t> fill(reverse_offsets_.begin(), reverse_offsets_.end() - 1);
+		for(uint32_t from = 0; from < number_of_states; ++from)
+		{
+			for(uint32_t k = 0; live_[ from ] && k < columns; ++k)
+			{
+				const uint32_t to = table_.GetClassTransition(from, k);
+				if(live_[ to ])
+				{
+					reverse_targets_[ fill[ static_cast<size_t>(to) * columns + k ]++ ] = from;
+				}
+			}
+		}
+
+		seen_.assign(number_of_states + 1, 0);
+		// A cached state costs its row of transitions, a few runs and roughly the overhead of a hash map node
+		const size_t state_size = columns * sizeof(uint32_t) + 128;
+		cache_capacity_ = static_cast<uint32_t>(std::min<size_t>(std::max<size_t>(cache_size / state_size, 4), kUnknownTransition - 1));
+		Flush();
+	}
+
+	uint32_t DFASearcher::Transition(uint32_t state, ByteClasses::Class class_id) const
+	{
+		uint32_t next = cached_transitions_[ static_cast<size_t>(state) * table_.GetNumberOfColumns() + class_id ];
+		if(next == kUnknownTransition)
+		{
+			next = ComputeTransition(state, class_id);
+		}
+		return next;
+	}
+
+	uint32_t DFASearcher::ComputeTransition(uint32_t state, ByteClasses::Class class_id) const
+	{
+		if(++epoch_ == 0)
+		{
+			std::fill(seen_.begin(), seen_.end(), 0);
+			epoch_ = 1;
+		}
+
+		// Every run takes the transition. A run is dropped if it can no longer accept or if an earlier started run is in the same
+		// state. For kLeftmostLongest, the groups after the first accepting one started later than its match, so they are cut off
+		const std::vector<uint32_t>& runs = *cached_runs_[ state ];
+		bool matched = runs[ 0 ] != 0;
+		std::vector<uint32_t> next_runs(1, 0);
+		size_t group_begin = next_runs.size();
+		bool group_accepts = false;
+		bool cut_off = false;
+		for(size_t i = 1; i < runs.size(); ++i)
+		{
+			if(runs[ i ] == kEndOfGroup)
+			{
+				if(next_runs.size() != group_begin)
+				{
+					std::sort(next_runs.begin() + group_begin, next_runs.end());
+					next_runs.push_back(kEndOfGroup);
+					if(group_accepts && kind_ == MatchKind::kLeftmostLongest)
+					{
+						matched = true;
+						cut_off = true;
+						break;
+					}
+				}
+				group_begin = next_runs.size();
+				group_accepts = false;
+				continue;
+			}
+
+			const uint32_t to = table_.GetClassTransition(runs[ i ], class_id);
+			if(live_[ to ] && seen_[ to ] != epoch_)
+			{
+				seen_[ to ] = epoch_;
+				next_runs.push_back(to);
+				group_accepts = group_accepts || accepting_lookup_[ to ];
+			}
+		}
+
+		// A new run starts after every character, unless the leftmost match was already found. For kAll all runs form one group
+		if(!cut_off && !matched && live_[ start_state_ ] && seen_[ start_state_ ] != epoch_)
+		{
+			if(kind_ == MatchKind::kAll && next_runs.size() > 1)
+			{
+				next_runs.back() = start_state_;
+				std::sort(next_runs.begin() + 1, next_runs.end());
+			}
+			else
+			{
+				next_runs.push_back(start_state_);
+			}
+			next_runs.push_back(kEndOfGroup);
+			matched = kind_ == MatchKind::kLeftmostLongest && accepting_lookup_[ start_state_ ];
+		}
+		next_runs[ 0 ] = matched;
+
+		const uint64_t flushes = number_of_flushes_;
+		uint32_t next = FindOrAddState(std::move(next_runs));
+		if(flushes == number_of_flushes_)
+		{
+			cached_transitions_[ static_cast<size_t>(state) * table_.GetNumberOfColumns() + class_id ] = next;
+		}
+		return next;
+	}
+
+	uint32_t DFASearcher::FindOrAddState(std::vector<uint32_t>&& runs) const
+	{
+		auto found = cached_state_index_.find(runs);
+		if(found != cached_state_index_.end())
+			return found->second;
+
+		if(cached_runs_.size() >= cache_capacity_)
+		{
+			Flush();
+			++number_of_flushes_;
+			found = cached_state_index_.find(runs);
+			if(found != cached_state_index_.end())
+				return found->second;
+		}
+
+		auto inserted = cached_state_index_.insert(std::make_pair(std::move(runs), static_cast<uint32_t>(cached_runs_.size())));
+		const std::vector<uint32_t>& key = inserted.first->first;
+		// A match ends in a state if its last group accepts. For kLeftmostLongest the last group of a matched state is the one
+		// with the leftmost match, for kAll there is only one group
+		bool last_group_accepts = false;
+		bool group_accepts = false;
+		for(size_t i = 1; i < key.size(); ++i)
+		{
+			if(key[ i ] == kEndOfGroup)
+			{
+				last_group_accepts = group_accepts;
+				group_accepts = false;
+			}
+			else
+			{
+				group_accepts = group_accepts || accepting_lookup_[ key[ i ] ];
+			}
+		}
+		uint8_t flags = 0;
+		if(last_group_accepts && (kind_ == MatchKind::kAll || key[ 0 ] != 0))
+			flags |= kMatchEnds;
+		if(key.size() == 1)
+			flags |= kNoRunsLeft;
+
+		cached_runs_.push_back(&key);
+		cached_flags_.push_back(flags);
+		cached_transitions_.resize(cached_transitions_.size() + table_.GetNumberOfColumns(), kUnknownTransition);
+
+		return inserted.first->second;
+	}
+
+	void DFASearcher::Flush() const
+	{
+		cached_state_index_.clear();
+		cached_runs_.clear();
+		cached_transitions_.clear();
+		cached_flags_.clear();
+
+		std::vector<uint32_t> initial_runs(1, kind_ == MatchKind::kLeftmostLongest && accepting_lookup_[ start_state_ ]);
+		if(live_[ start_state_ ])
+		{
+			initial_runs.push_back(start_state_);
+			initial_runs.push_back(kEndOfGroup);
+		}
+		initial_state_ = FindOrAddState(std::move(initial_runs));
+	}
+
+	size_t DFASearcher::FindMatchBegin(const char* data, size_t lower_bound, size_t end) const
+	{
+		// Runs the DFA backwards from its accepting states. The states reached at position k are those, from which
+		// the text in [k, end) leads to an accepting state, so a match starts at k if the start state is among them
+		const uint32_t columns = table_.GetNumberOfColumns();
+		std::vector<uint32_t> current(accepting_states_);
+		std::vector<uint32_t> previous;
+		size_t begin = accepting_lookup_[ start_state_ ] ? end : kNoMatch;
+		for(size_t k = end; k > lower_bound && !current.empty(); --k)
+		{
+			if(++epoch_ == 0)
+			{
+				std::fill(seen_.begin(), seen_.end(), 0);
+				epoch_ = 1;
+			}
+			const ByteClasses::Class class_id = table_.GetByteClasses().Get(data[ k - 1 ]);
+			previous.clear();
+			for(uint32_t to : current)
+			{
+				const size_t row = static_cast<size_t>(to) * columns + class_id;
+				for(uint32_t i = reverse_offsets_[ row ]; i < reverse_offsets_[ row + 1 ]; ++i)
+				{
+					const uint32_t from = reverse_targets_[ i ];
+					if(seen_[ from ] != epoch_)
+					{
+						seen_[ from ] = epoch_;
+						previous.push_back(from);
+					}
+				}
+			}
+			current.swap(previous);
+			if(seen_[ start_state_ ] == epoch_)
+			{
+				begin = k - 1;
+			}
+		}
+		return begin;
+	}
+
+	void DFASearcher::Find(const char* data, size_t size, const std::function<bool(const Match&)>& on_match) const
+	{
+		if(!live_[ start_state_ ])
+			return;
+
+		const ByteClasses& classes = table_.GetByteClasses();
+		if(kind_ == MatchKind::kAll)
+		{
+			FindAll(data, size, on_match);
+			return;
+		}
+
+		// After a match the search starts over at its end (or after it, if it is empty). A match after position contains an occurrence
+		// of the required substring, which starts at or after position
+		const char* required_substring = prefilter_.FindRequiredSubstring(data, data + size);
+		for(size_t position = 0; position <= size;)
+		{
+			if(required_substring < data + position)
+			{
+				required_substring = prefilter_.FindRequiredSubstring(data + position, data + size);
+			}
+			if(required_substring == data + size && !prefilter_.GetRequiredSubstring().empty())
+				return;
+
+			uint32_t state = initial_state_;
+			size_t match_end = (cached_flags_[ state ] & kMatchEnds) ? position : kNoMatch;
+			for(size_t i = position; i < size && !(cached_flags_[ state ] & kNoRunsLeft);)
+			{
+				if(state == initial_state_ && prefilter_.SkipsCharacters())
+				{
+					i = prefilter_.FindCandidate(data + i, data + size) - data;
+					if(i == size)
+						break;
+				}
+				state = Transition(state, classes.Get(data[ i++ ]));
+				if(cached_flags_[ state ] & kMatchEnds)
+				{
+					match_end = i;
+				}
+			}
+			if(match_end == kNoMatch)
+				return;
+
+			Match match{ FindMatchBegin(data, position, match_end), match_end };
+			if(!on_match(match))
+				return;
+			position = match.end > match.begin ? match.end : match.end + 1;
+		}
+	}
+
+	void DFASearcher::FindAll(const char* data, size_t size, const std::function<bool(const Match&)>& on_match) const
+	{
+		if(!prefilter_.GetRequiredSubstring().empty() && prefilter_.FindRequiredSubstring(data, data + size) == data + size)
+			return;
+		if(accepting_lookup_[ start_state_ ] && !on_match(Match{ 0, 0 }))
+			return;
+
+		// The cached states tell where matches end. Their starts come from the runs with their starting positions, ordered by
+		// them, which are followed one character at a time from synced_position on, up to the end of the next match. A run is
+		// dropped if an earlier started run is in the same state, so the first accepting run has the earliest start
+		const ByteClasses& classes = table_.GetByteClasses();
+		const uint32_t columns = table_.GetNumberOfColumns();
+		std::vector<std::pair<uint32_t, size_t> > runs(1, std::make_pair(start_state_, 0));
+		std::vector<std::pair<uint32_t, size_t> > next_runs;
+		size_t synced_position = 0;
+		auto follow_runs = [&]() -> size_t
+		{
+			if(++epoch_ == 0)
+			{
+				std::fill(seen_.begin(), seen_.end(), 0);
+				epoch_ = 1;
+			}
+			const ByteClasses::Class class_id = classes.Get(data[ synced_position ]);
+			size_t begin = kNoMatch;
+			next_runs.clear();
+			for(const std::pair<uint32_t, size_t>& run : runs)
+			{
+				const uint32_t to = table_.GetClassTransition(run.first, class_id);
+				if(live_[ to ] && seen_[ to ] != epoch_)
+				{
+					seen_[ to ] = epoch_;
+					next_runs.push_back(std::make_pair(to, run.second));
+					if(begin == kNoMatch && accepting_lookup_[ to ])
+					{
+						begin = run.second;
+					}
+				}
+			}
+			// A new run starts after every character
+			++synced_position;
+			if(seen_[ start_state_ ] != epoch_)
+			{
+				next_runs.push_back(std::make_pair(start_state_, synced_position));
+				if(begin == kNoMatch && accepting_lookup_[ start_state_ ])
+				{
+					begin = synced_position;
+				}
+			}
+			runs.swap(next_runs);
+			return begin;
+		};
+
+		// If the start state can be entered again, a run in it may have started earlier, so in the initial cached state the runs
+		// are known only after a character was skipped
+		const bool start_is_entered = reverse_offsets_[ (static_cast<size_t>(start_state_) + 1) * columns ] != reverse_offsets_[ static_cast<size_t>(start_state_) * columns ];
+		uint32_t state = initial_state_;
+		for(size_t i = 0; i < size; ++i)
+		{
+			if(state == initial_state_)
+			{
+				// Without runs in progress, the search continues at the next character, which may start a match
+				const size_t candidate = prefilter_.SkipsCharacters() ? prefilter_.FindCandidate(data + i, data + size) - data : i;
+				if(candidate == size)
+					break;
+				if(candidate != i || !start_is_entered)
+				{
+					runs.assign(1, std::make_pair(start_state_, candidate));
+					synced_position = candidate;
+				}
+				i = candidate;
+			}
+			state = Transition(state, classes.Get(data[ i ]));
+			if(cached_flags_[ state ] & kMatchEnds)
+			{
+				size_t begin = kNoMatch;
+				while(synced_position <= i)
+				{
+					begin = follow_runs();
+				}
+				if(!on_match(Match{ begin, i + 1 }))
+					return;
+			}
+		}
+	}
+
+	std::vector<Match> DFASearcher::Find(const char* data, size_t size) const
+	{
+		std::vector<Match> matches;
+		Find(data, size, [&matches](const Match& match) { matches.push_back(match); return true; });
+		return matches;
+	}
+
+	bool DFASearcher::Contains(const char* data, size_t size) const
+	{
+		if(!live_[ start_state_ ])
+			return false;
+		if(!prefilter_.GetRequiredSubstring().empty() && prefilter_.FindRequiredSubstring(data, data + size) == data + size)
+			return false;
+
+		uint32_t state = initial_state_;
+		const ByteClasses& classes = table_.GetByteClasses();
+		for(size_t i = 0; !(cached_flags_[ state ] & kMatchEnds); ++i)
+		{
+			if(state == initial_state_ && prefilter_.SkipsCharacters())
+			{
+				i = prefilter_.FindCandidate(data + i, data + size) - data;
+			}
+			if(i == size)
+				return false;
+			state = Transition(state, classes.Get(data[ i ]));
+		}
+		return true;
+	}
+}
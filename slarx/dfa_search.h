@@ -0,0 +1,105 @@
+#pragma once
+#ifndef SLARX_DFA_SEARCH_H_INCLUDED
+#define SLARX_DFA_SEARCH_H_INCLUDED
+
+#include "dfa.h"
+#include "utility.h"
+#include "prefilter.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace slarx
+{
+	// An occurrence of a word of the language in a text. The word is the text in [begin, end)
+	struct Match
+	{
+		size_t begin;
+		size_t end;
+	};
+
+	enum class MatchKind
+	{
+		// Non-overlapping matches. At every position the match, which starts first, is taken and among those the longest one
+		kLeftmostLongest,
+		// One match for every position at which some match ends, starting at the first position any match ending there starts
+		kAll
+	};
+
+	// Finds the occurrences of the words of a DFA's language in a text in a single forward pass, instead of recognizing every
+	// substring. The pass runs a lazily built DFA, whose states are the states of all runs of the original DFA, which were
+	// started at earlier positions and can still accept. For kLeftmostLongest the runs are kept in groups ordered by their
+	// starting position, so the end of the leftmost-longest match is known when the groups up to the matching one die.
+	// The start of a match is then found by running the DFA backwards over the match only. For kAll the starting positions of
+	// the runs are tracked instead, because the matches may overlap. While no run is in progress, the
+	// search skips ahead to the next possible first character of a word and it ends once the required substring is missing.
+	// Like LazyDFA, searching updates the cache of states, so a DFASearcher must not be shared between threads
+	class DFASearcher
+	{
+	public:
+		static const size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+		// cache_size is the approximate number of bytes the cached states may occupy
+		explicit DFASearcher(const DFA& dfa, MatchKind kind = MatchKind::kLeftmostLongest, size_t cache_size = kDefaultCacheSize);
+
+		// Calls on_match for every match in [data, data + size) in order of their ends. The search stops early if on_match returns false
+		void Find(const char* data, size_t size, const std::function<bool(const Match&)>& on_match) const;
+		std::vector<Match> Find(const char* data, size_t size) const;
+		// Returns true if any substring of [data, data + size) is in the language
+		bool Contains(const char* data, size_t size) const;
+
+		MatchKind GetMatchKind() const { return kind_; }
+
+	private:
+		static const uint32_t kUnknownTransition = UINT32_MAX;
+		// Ends a group of runs in the representation of a state
+		static const uint32_t kEndOfGroup = UINT32_MAX;
+		// Flags of a cached state
+		static const uint8_t kMatchEnds = 1;
+		static const uint8_t kNoRunsLeft = 2;
+
+		// Returns the cached state, which the cached state state goes to on class_id, computing and caching it if needed.
+		// If the cache is flushed, state is no longer valid and only the returned state is
+		uint32_t Transition(uint32_t state, ByteClasses::Class class_id) const;
+		uint32_t ComputeTransition(uint32_t state, ByteClasses::Class class_id) const;
+		uint32_t FindOrAddState(std::vector<uint32_t>&& runs) const;
+		void Flush() const;
+		// Returns the first position in [lower_bound, end], at which a match ending at end starts. A match must end at end
+		size_t FindMatchBegin(const char* data, size_t lower_bound, size_t end) const;
+		// Find for kAll. Matches may overlap, so scanning backwards from every match end would be quadratic. Instead, the runs are
+		// followed one by one together with their starting positions up to every match end. Every character is followed at most
+		// once, so this takes time linear in size (times the number of runs)
+		void FindAll(const char* data, size_t size, const std::function<bool(const Match&)>& on_match) const;
+
+		MatchKind kind_;
+		DFATransitionTable table_;
+		uint32_t start_state_;
+		std::vector<uint8_t> accepting_lookup_;
+		std::vector<uint32_t> accepting_states_;
+		// live_[ s ] is 1 if an accepting state is reachable from s
+		std::vector<uint8_t> live_;
+		// The states, which go to state t on class k, are reverse_targets_[ reverse_offsets_[ t * columns + k ] ..
+		// reverse_offsets_[ t * columns + k + 1 ] ). Only transitions between live states are kept
+		std::vector<uint32_t> reverse_offsets_;
+		std::vector<uint32_t> reverse_targets_;
+		uint32_t cache_capacity_;
+		Prefilter prefilter_;
+
+		// The cache. State i is described by *cached_runs_[ i ] (a key of cached_state_index_), which starts with 1 if a match
+		// was found and continues with the groups of DFA states, each ended by kEndOfGroup. Its row of transitions starts at
+		// cached_transitions_[ i * columns ]
+		mutable std::unordered_map<std::vector<uint32_t>, uint32_t, ContainerHash> cached_state_index_;
+		mutable std::vector<const std::vector<uint32_t>*> cached_runs_;
+		mutable std::vector<uint32_t> cached_transitions_;
+		mutable std::vector<uint8_t> cached_flags_;
+		mutable uint32_t initial_state_;
+		mutable uint64_t number_of_flushes_;
+		// Scratch space for ComputeTransition and FindMatchBegin
+		mutable std::vector<uint32_t> seen_;
+		mutable uint32_t epoch_;
+	};
+}
+
+#endif // SLARX_DFA_SEARCH_H_INCLUDED
@@ -0,0 +1,17 @@
+#include "dfa_stream_matcher.h"
+
+namespace slarx
+{
+	bool DFAStreamMatcher::Finish()
+	{
+		bool is_accepting = IsAccepting();
+		Reset();
+		return is_accepting;
+	}
+
+	bool DFAStreamMatcher::IsDecided() const
+	{
+		DFA::StateKind kind = dfa_->GetStateKind(state_);
+		return kind == DFA::StateKind::kDead || kind == DFA::StateKind::kAcceptingSink;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef SLARX_DFA_STREAM_MATCHER_H_INCLUDED
+#define SLARX_DFA_STREAM_MATCHER_H_INCLUDED
+
+#include "dfa.h"
+#include <string_view>
+#include <cstdint>
+
+namespace slarx
+{
+	// Recognizes a word, which arrives in pieces (e.g. packets or file blocks), without joining the pieces. The pieces may be
+	// split anywhere and are read in place. Only a pointer to the DFA and the reached row of its transition table are kept,
+	// so many streams can be matched at once at the cost of a few bytes each. The DFA must outlive the matcher and must not
+	// change while it is used. Matchers of the same DFA may be used from different threads
+	class DFAStreamMatcher
+	{
+	public:
+		explicit DFAStreamMatcher(const DFA& dfa) : dfa_(&dfa), state_(dfa.GetStartState().GetValue()) { }
+
+		// Continues the word with [data, data + size)
+		void Feed(const char* data, size_t size) { state_ = dfa_->Advance(state_, data, size); }
+		void Feed(std::string_view piece) { Feed(piece.data(), piece.size()); }
+		// Returns true if the word fed so far is in the language and starts a new word
+		bool Finish();
+		// Starts a new word, discarding the one fed so far
+		void Reset() { state_ = dfa_->GetStartState().GetValue(); }
+
+		// Returns true if the word fed so far is in the language. Feeding may continue afterwards
+		bool IsAccepting() const { return dfa_->GetAcceptingLookup()[ state_ ] != 0; }
+		// Returns true if no continuation of the word fed so far can change whether it is accepted, so feeding can stop
+		bool IsDecided() const;
+
+	private:
+		const DFA* dfa_;
+		// Row of the transition table of dfa_
+		uint32_t state_;
+	};
+}
+
+#endif // SLARX_DFA_STREAM_MATCHER_H_INCLUDED
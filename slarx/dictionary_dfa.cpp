@@ -0,0 +1,200 @@
+#include "dictionary_dfa.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace slarx
+{
+	DictionaryDFABuilder::DictionaryDFABuilder() : number_of_words_(0)
+	{
+		path_.push_back(NewNode());
+	}
+
+	uint32_t DictionaryDFABuilder::NewNode()
+	{
+		if(!free_nodes_.empty())
+		{
+			const uint32_t node = free_nodes_.back();
+			free_nodes_.pop_back();
+			return node;
+		}
+		nodes_.push_back(Node{ false, std::vector<std::pair<char, uint32_t> >() });
+		return static_cast<uint32_t>(nodes_.size() - 1);
+	}
+
+	void DictionaryDFABuilder::Add(std::string_view word)
+	{
+		if(number_of_words_ != 0)
+		{
+			const int order = word.compare(last_word_);
+			if(order == 0)
+				return;
+			if(order < 0)
+				throw std::invalid_argument("The words of a dictionary must be sorted, but \"" + std::string(word) + "\" comes after \"" + last_word_ + "\".");
+		}
+		if(word.find(kEpsilon) != std::string_view::npos)
+			throw std::invalid_argument(std::string("The words of a dictionary may not contain '") + kEpsilon + "'.");
+
+		size_t common_prefix = 0;
+		while(common_prefix < word.size() && common_prefix < last_word_.size() && word[ common_prefix ] == last_word_[ common_prefix ])
+		{
+			++common_prefix;
+		}
+		Minimize(common_prefix);
+
+		for(size_t i = common_prefix; i < word.size(); ++i)
+		{
+			const uint32_t node = NewNode();
+			nodes_[ path_.back() ].transitions.push_back(std::make_pair(word[ i ], node));
+			path_.push_back(node);
+		}
+		nodes_[ path_.back() ].is_accepting = true;
+		last_word_.assign(word.data(), word.size());
+		++number_of_words_;
+	}
+
+	void DictionaryDFABuilder::Minimize(size_t depth)
+	{
+		std::vector<uint32_t> key;
+		for(size_t i = path_.size() - 1; i > depth; --i)
+		{
+			const uint32_t node = path_[ i ];
+			Node& node_data = nodes_[ node ];
+			key.clear();
+			key.push_back(node_data.is_accepting);
+			for(const std::pair<char, uint32_t>& transition : node_data.transitions)
+			{
+				key.push_back(static_cast<unsigned char>(transition.first));
+				key.push_back(transition.second);
+			}
+
+			auto found = register_.find(key);
+			if(found == register_.end())
+			{
+				register_.emplace(std::move(key), node);
+				continue;
+			}
+			// The parent's last transition leads to the node, because the node lies on the path of the last word
+			nodes_[ path_[ i - 1 ] ].transitions.back().second = found->second;
+			node_data.is_accepting = false;
+			node_data.transitions.clear();
+			free_nodes_.push_back(node);
+		}
+		path_.resize(depth + 1);
+	}
+
+	DFA DictionaryDFABuilder::Build(bool report_automaton_was_created)
+	{
+		Minimize(0);
+
+		// The reachable nodes are numbered in breadth first order from the root, which becomes state 0
+		std::vector<uint32_t> state_of_node(nodes_.size(), UINT32_MAX);
+		std::vector<uint32_t> order(1, path_[ 0 ]);
+		state_of_node[ path_[ 0 ] ] = 0;
+		// columns[ c ] lists the transitions on c as (from << 32) | to, which is used to group characters with identical columns
+		std::vector<std::vector<uint64_t> > columns(256);
+		Alphabet alphabet;
+		std::set<State> accepting_states;
+		for(uint32_t i = 0; i < order.size(); ++i)
+		{
+			const Node& node = nodes_[ order[ i ] ];
+			if(node.is_accepting)
+			{
+				accepting_states.insert(State(i));
+			}
+			for(const std::pair<char, uint32_t>& transition : node.transitions)
+			{
+				if(state_of_node[ transition.second ] == UINT32_MAX)
+				{
+					state_of_node[ transition.second ] = static_cast<uint32_t>(order.size());
+					order.push_back(transition.second);
+				}
+				if(!alphabet.Contains(transition.first))
+				{
+					alphabet.AddCharacter(transition.first);
+				}
+				columns[ static_cast<unsigned char>(transition.first) ].push_back((static_cast<uint64_t>(i) << 32) | state_of_node[ transition.second ]);
+			}
+		}
+
+		// Characters with identical columns share a class up front, so the table is never as wide as the whole alphabet
+		std::map<std::vector<uint64_t>, uint32_t> column_groups;
+		ByteClasses classes(alphabet, false);
+		classes.Refine([&](unsigned char c) -> uint32_t
+		{
+			return column_groups.insert(std::make_pair(columns[ c ], static_cast<uint32_t>(column_groups.size()))).first->second;
+		});
+		std::vector<char> class_representatives = classes.GetRepresentatives();
+
+		// A DFA must be complete over its alphabet (e.g. for Complement and Export), so the transitions missing from the trie lead
+		// to a dead state, which gets the row after the nodes. The row is dropped again if no transition is missing
+		uint32_t number_of_states = static_cast<uint32_t>(order.size());
+		DFATransitionTable transition_table(number_of_states + 1, alphabet, classes);
+		for(char c : class_representatives)
+		{
+			for(uint64_t transition : columns[ static_cast<unsigned char>(c) ])
+			{
+				transition_table.AddTransition(State(static_cast<uint32_t>(transition >> 32)), c, State(static_cast<uint32_t>(transition)));
+			}
+		}
+		const uint32_t dead_state = number_of_states;
+		bool has_dead_state = false;
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			for(ByteClasses::Class k = 1; k < classes.Size(); ++k)
+			{
+				if(transition_table.GetClassTransition(s, k) == DFATransitionTable::kNoTransition)
+				{
+					transition_table.SetClassTransition(s, k, dead_state);
+					has_dead_state = true;
+				}
+			}
+		}
+		if(has_dead_state)
+		{
+			for(ByteClasses::Class k = 1; k < classes.Size(); ++k)
+			{
+				transition_table.SetClassTransition(dead_state, k, dead_state);
+			}
+			++number_of_states;
+		}
+		else
+		{
+			transition_table.SetNumberOfStates(number_of_states);
+		}
+
+		nodes_.clear();
+		free_nodes_.clear();
+		register_.clear();
+		last_word_.clear();
+		path_.assign(1, NewNode());
+		number_of_words_ = 0;
+
+		State start_state = State(0);
+		return DFA(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states),
+				   std::move(transition_table), report_automaton_was_created);
+	}
+
+	DFA BuildDictionaryDFA(const std::vector<std::string_view>& words, bool is_sorted, bool report_automaton_was_created)
+	{
+		DictionaryDFABuilder builder;
+		if(is_sorted)
+		{
+			for(std::string_view word : words)
+			{
+				builder.Add(word);
+			}
+			return builder.Build(report_automaton_was_created);
+		}
+
+		std::vector<std::string_view> sorted_words(words);
+		std::sort(sorted_words.begin(), sorted_words.end());
+		for(std::string_view word : sorted_words)
+		{
+			builder.Add(word);
+		}
+		return builder.Build(report_automaton_was_created);
+	}
+}
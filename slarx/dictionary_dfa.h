@@ -0,0 +1,63 @@
+#pragma once
+#ifndef SLARX_DICTIONARY_DFA_H_INCLUDED
+#define SLARX_DICTIONARY_DFA_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "dfa.h"
+#include "utility.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace slarx
+{
+	// Builds the minimal DFA of a finite language from its words in sorted order, in a single pass (Daciuk, Mihov, Watson and
+	// Watson). The words are added to a trie, whose states are minimized as soon as no later word can pass through them: when
+	// a word is added, the states of the previous word past their common prefix are final, so each of them is either replaced
+	// by an equivalent state from the register of minimized states or added to it. Equivalent states of an acyclic DFA have
+	// the same finality and the same transitions, so the register is a hash map keyed by them. Only the minimized states and
+	// the path of the last word are kept, so memory stays proportional to the size of the minimal DFA
+	class DictionaryDFABuilder
+	{
+	public:
+		DictionaryDFABuilder();
+
+		// Adds a word, which must not be smaller (in the byte order of std::string) than the previously added word. Adding
+		// the previous word again has no effect. Throws std::invalid_argument if the word is out of order or contains kEpsilon
+		void Add(std::string_view word);
+		// Returns the minimal DFA of the added words and leaves the builder empty. Unless the alphabet is empty, the DFA has a dead
+		// state, to which the words, that are not prefixes of added words, lead
+		DFA Build(bool report_automaton_was_created = false);
+
+		size_t GetNumberOfWords() const { return number_of_words_; }
+
+	private:
+		struct Node
+		{
+			bool is_accepting;
+			// Sorted by character, because the words arrive in sorted order
+			std::vector<std::pair<char, uint32_t> > transitions;
+		};
+
+		uint32_t NewNode();
+		// Replaces or registers the nodes of the last word's path deeper than depth, starting from the deepest one
+		void Minimize(size_t depth);
+
+		std::vector<Node> nodes_;
+		// Indices of nodes, which were replaced by an equivalent node and may be reused
+		std::vector<uint32_t> free_nodes_;
+		// Keyed by the finality and the transitions of a minimized node, packed as { is_accepting, character, target, ... }
+		std::unordered_map<std::vector<uint32_t>, uint32_t, ContainerHash> register_;
+		std::string last_word_;
+		// path_[ i ] is the node reached by the first i characters of last_word_. path_[ 0 ] is the root
+		std::vector<uint32_t> path_;
+		size_t number_of_words_;
+	};
+
+	// Builds the minimal DFA of the words. If is_sorted is false, the words are sorted first
+	DFA BuildDictionaryDFA(const std::vector<std::string_view>& words, bool is_sorted = true, bool report_automaton_was_created = false);
+}
+
+#endif // SLARX_DICTIONARY_DFA_H_INCLUDED
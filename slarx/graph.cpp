@@ -2,181 +2,294 @@
 #include <iostream>
 #include <algorithm>
 #include <iterator>
-#include <queue>
 
 namespace slarx
 {
+	// Counting sort of the edges by their target
 	DirectedGraph Transpose(const DirectedGraph& G)
 	{
-		DirectedGraph GT(G.size());
-		for(int u = 0; u < G.size(); ++u)
+		std::vector<uint32_t> offsets(G.Size() + 1, 0);
+		for(uint32_t u = 0; u < G.Size(); ++u)
 		{
-			for(int v : G[ u ])
+			for(uint32_t v : G[ u ])
 			{
-				GT[ v ].insert(u);
+				++offsets[ v + 1 ];
+			}
+		}
+		for(uint32_t v = 0; v < G.Size(); ++v)
+		{
+			offsets[ v + 1 ] += offsets[ v ];
+		}
+		std::vector<uint32_t> targets(G.GetNumberOfEdges());
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for(uint32_t u = 0; u < G.Size(); ++u)
+		{
+			for(uint32_t v : G[ u ])
+			{
+				targets[ fill[ v ]++ ] = u;
 			}
 		}
 
-		return GT;
+		return DirectedGraph(std::move(offsets), std::move(targets));
 	}
 
-	// Implements finding SCC using Kosaraju's algorithm
-	std::vector<std::set<int> > FindSCC(const DirectedGraph& G)
+	std::vector<std::vector<uint32_t> > FindSCC(const DirectedGraph& G)
 	{
-		std::vector<int> finish_time = DFS(G);
-		std::vector<int> order;
-		for(int i = G.size()-1; i >= 0; --i)
+		const uint32_t kUnvisited = UINT32_MAX;
+		std::vector<uint32_t> index(G.Size(), kUnvisited);
+		std::vector<uint32_t> low_link(G.Size(), 0);
+		std::vector<bool> on_stack(G.Size(), false);
+		std::vector<uint32_t> component_stack;
+		// Explicit DFS stack of (vertex, next unexplored successor of the vertex)
+		std::vector<std::pair<uint32_t, const uint32_t*> > call_stack;
+		std::vector<std::vector<uint32_t> > SCC;
+		uint32_t next_index = 0;
+
+		for(uint32_t root = 0; root < G.Size(); ++root)
 		{
-			for(int j = 0; j < G.size(); ++j)
+			if(index[ root ] != kUnvisited)
+				continue;
+
+			index[ root ] = low_link[ root ] = next_index++;
+			component_stack.push_back(root);
+			on_stack[ root ] = true;
+			call_stack.push_back(std::make_pair(root, G[ root ].begin()));
+			while(!call_stack.empty())
 			{
-				if(finish_time[ j ] == i)
+				uint32_t u = call_stack.back().first;
+				const uint32_t*& next = call_stack.back().second;
+				if(next != G[ u ].end())
 				{
-					order.push_back(j);
-					break;
+					uint32_t v = *next;
+					++next;
+					if(index[ v ] == kUnvisited)
+					{
+						index[ v ] = low_link[ v ] = next_index++;
+						component_stack.push_back(v);
+						on_stack[ v ] = true;
+						call_stack.push_back(std::make_pair(v, G[ v ].begin()));
+					}
+					else if(on_stack[ v ])
+					{
+						low_link[ u ] = std::min(low_link[ u ], index[ v ]);
+					}
+					continue;
+				}
+
+				// All successors of u are explored - return from u
+				call_stack.pop_back();
+				if(!call_stack.empty())
+				{
+					uint32_t parent = call_stack.back().first;
+					low_link[ parent ] = std::min(low_link[ parent ], low_link[ u ]);
+				}
+				if(low_link[ u ] == index[ u ])
+				{
+					std::vector<uint32_t> component;
+					uint32_t v;
+					do
+					{
+						v = component_stack.back();
+						component_stack.pop_back();
+						on_stack[ v ] = false;
+						component.push_back(v);
+					}while(v != u);
+					SCC.push_back(std::move(component));
 				}
 			}
 		}
 
-		return DFS2(Transpose(G), order);
+		// Tarjan's algorithm completes components in reverse topological order
+		std::reverse(SCC.begin(), SCC.end());
+		return SCC;
 	}
 
-	std::vector<int> DFS(const DirectedGraph& G)
+	// Runs BFS. Returns the vertices, reachable from start
+	std::vector<bool> Reachable(const DirectedGraph& G, uint32_t start)
 	{
-		std::vector<int> finish_time(G.size());
-		std::vector<bool> visited(G.size(), false);
-		int time = 0;
-		for(int i = 0; i < G.size(); ++i)
+		std::vector<bool> reachable(G.Size(), false);
+		reachable[ start ] = true;
+		std::vector<uint32_t> Q;
+		Q.push_back(start);
+		for(size_t head = 0; head < Q.size(); ++head)
 		{
-			if(!visited[ i ])
+			uint32_t u = Q[ head ];
+			for(uint32_t v : G[ u ])
 			{
-				visited[ i ] = true;
-				DFS_Visit(i, G, visited, finish_time, time);
+				if(!reachable[ v ])
+				{
+					reachable[ v ] = true;
+					Q.push_back(v);
+				}
 			}
 		}
-
-		return finish_time;
+		
+		return reachable;
 	}
 
-	void DFS_Visit(int u, const DirectedGraph& G, std::vector<bool>& visited, std::vector<int>& finish_time, int& time)
+	// Runs BFS on the transpose of G from all targets at once
+	std::vector<bool> CoReachable(const DirectedGraph& G, const std::vector<uint32_t>& targets)
 	{
-		for(int v : G[ u ])
+		DirectedGraph GT = Transpose(G);
+		std::vector<bool> co_reachable(G.Size(), false);
+		std::vector<uint32_t> Q;
+		for(uint32_t t : targets)
 		{
-			if(!visited[ v ])
+			if(!co_reachable[ t ])
 			{
-				visited[ v ] = true;
-				DFS_Visit(v, G, visited, finish_time, time);
+				co_reachable[ t ] = true;
+				Q.push_back(t);
+			}
+		}
+		for(size_t head = 0; head < Q.size(); ++head)
+		{
+			uint32_t u = Q[ head ];
+			for(uint32_t v : GT[ u ])
+			{
+				if(!co_reachable[ v ])
+				{
+					co_reachable[ v ] = true;
+					Q.push_back(v);
+				}
 			}
 		}
 
-		finish_time[ u ] = time;
-		time++;
+		return co_reachable;
 	}
 
-	std::vector<std::set<int> > DFS2(const DirectedGraph& G, const std::vector<int>& order)
+	// Uses Kahn's algorithm - the subgraph is acyclic if and only if all of its vertices can be removed in topological order
+	bool HasCycle(const DirectedGraph& G, const std::vector<bool>& in_subgraph)
 	{
-		std::vector<std::set<int> > SCC; // The SCCs
-		std::vector<int> finish_time(G.size());
-		std::vector<bool> visited(G.size(), false);
-		for(int i : order)
+		std::vector<uint32_t> in_degree(G.Size(), 0);
+		uint32_t subgraph_size = 0;
+		for(uint32_t u = 0; u < G.Size(); ++u)
 		{
-			std::set<int> component;
-			if(!visited[ i ])
+			if(!in_subgraph[ u ])
+				continue;
+			++subgraph_size;
+			for(uint32_t v : G[ u ])
 			{
-				visited[ i ] = true;
-				component.insert(i);
-				DFS2_Visit(i, component, G, visited);
+				if(in_subgraph[ v ])
+					++in_degree[ v ];
 			}
-			if(component.size() != 0)
-				SCC.push_back(component);
 		}
-		
-		return SCC;
-	}
 
-	void DFS2_Visit(int u, std::set<int>& component, const DirectedGraph& G, std::vector<bool>& visited)
-	{
-		for(int v : G[ u ])
+		std::vector<uint32_t> ready;
+		for(uint32_t u = 0; u < G.Size(); ++u)
+		{
+			if(in_subgraph[ u ] && in_degree[ u ] == 0)
+				ready.push_back(u);
+		}
+		uint32_t removed = 0;
+		while(!ready.empty())
 		{
-			if(!visited[ v ])
+			uint32_t u = ready.back();
+			ready.pop_back();
+			++removed;
+			for(uint32_t v : G[ u ])
 			{
-				visited[ v ] = true;
-				component.insert(v);
-				DFS2_Visit(v, component, G, visited);
+				if(in_subgraph[ v ] && --in_degree[ v ] == 0)
+					ready.push_back(v);
 			}
 		}
-	}
 
-	
+		return removed != subgraph_size;
+	}
 
-	// Runs BFS. Returns set of vertices, reachable from start
-	std::set<int> Reachable(const DirectedGraph& G, int start)
+	std::vector<uint32_t> ImmediateDominators(const DirectedGraph& G, uint32_t start)
 	{
-		std::set<int> reachable;
-		reachable.insert(start);
-		std::queue<int> Q;
-		Q.push(start);
-		while(!Q.empty())
-		{
-			int u = Q.front();
-			Q.pop();
-			for(int v : G[ u ])
+		// Numbers the reachable vertices in postorder with an explicit stack
+		std::vector<uint32_t> postorder_number(G.Size(), kNoDominator);
+		std::vector<uint32_t> postorder;
+		std::vector<bool> visited(G.Size(), false);
+		std::vector<std::pair<uint32_t, const uint32_t*> > stack;
+		visited[ start ] = true;
+		stack.push_back(std::make_pair(start, G[ start ].begin()));
+		while(!stack.empty())
+		{
+			uint32_t u = stack.back().first;
+			const uint32_t*& next = stack.back().second;
+			if(next != G[ u ].end())
 			{
-				if(reachable.find(v) == reachable.end())
+				uint32_t v = *next++;
+				if(!visited[ v ])
 				{
-					reachable.insert(v);
-					Q.push(v);
+					visited[ v ] = true;
+					stack.push_back(std::make_pair(v, G[ v ].begin()));
 				}
+				continue;
 			}
+			postorder_number[ u ] = static_cast<uint32_t>(postorder.size());
+			postorder.push_back(u);
+			stack.pop_back();
 		}
-		
-		return reachable;
-	}
 
-	bool IsLanguageInfinite_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states)
-	{
-		std::vector<std::set<int> > SCC = FindSCC(G);
-		auto new_end = std::remove_if(SCC.begin(), SCC.end(), [&G](const std::set<int>& s){ auto bg = s.begin(); return (s.size() <= 1) && (G[*bg].find(*bg) == G[*bg].end()); });
-		SCC.erase(new_end, SCC.end());
-		int start_state = automaton_start_state.GetValue();
-		std::set<int> final_states;
-		for(State s : automaton_accepting_states)
+		// Walks up the dominator tree from both vertices to their nearest common dominator, using that dominators have larger postorder numbers
+		std::vector<uint32_t> dominator(G.Size(), kNoDominator);
+		auto intersect = [&](uint32_t a, uint32_t b)
 		{
-			final_states.insert(s.GetValue());
-		}
-		std::set<int> reachable_from_start_state = Reachable(G, start_state);
-		for(std::set<int> scc : SCC)
+			while(a != b)
+			{
+				while(postorder_number[ a ] < postorder_number[ b ])
+					a = dominator[ a ];
+				while(postorder_number[ b ] < postorder_number[ a ])
+					b = dominator[ b ];
+			}
+			return a;
+		};
+
+		DirectedGraph GT = Transpose(G);
+		dominator[ start ] = start;
+		for(bool changed = true; changed;)
 		{
-			// Compute all vertices reachable from the current strongly connected component. Obviously if a vertex is reachable from one scc vertex, it is reachable from all of them
-			std::set<int> reachable_from_scc = Reachable(G, *scc.begin());
-			// The scc must be reachable from the start state if the language is infinite
-			if(reachable_from_start_state.find(*scc.begin()) != reachable_from_start_state.end())
+			changed = false;
+			// Reverse postorder, skipping the start vertex
+			for(size_t i = postorder.size() - 1; i-- > 0;)
 			{
-				for(int fs : final_states)
+				const uint32_t u = postorder[ i ];
+				uint32_t new_dominator = kNoDominator;
+				for(uint32_t p : GT[ u ])
 				{
-					// If any final vertex is reachable from the scc, then we can go through it an arbitrary amount of times and proceed to that final vertex
-					if(scc.find(fs) != scc.end())
-					{
-						return true;
-					}
+					if(dominator[ p ] == kNoDominator)
+						continue;
+					new_dominator = new_dominator == kNoDominator ? p : intersect(p, new_dominator);
+				}
+				if(dominator[ u ] != new_dominator)
+				{
+					dominator[ u ] = new_dominator;
+					changed = true;
 				}
 			}
 		}
 
-		return false;
+		return dominator;
 	}
 
-	bool IsLanguageEmpty_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states)
+	// The language is infinite if and only if a cycle lies on some path from the start state to an accepting state. States,
+	// which are not reachable or from which no accepting state is reachable, are trimmed and the rest is checked for a cycle
+	bool IsLanguageInfinite_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states)
 	{
-		int start_state = automaton_start_state.GetValue();
-		std::set<int> final_states;
+		std::vector<uint32_t> final_states;
 		for(State s : automaton_accepting_states)
 		{
-			final_states.insert(s.GetValue());
+			final_states.push_back(s.GetValue());
 		}
-		std::set<int> reachable_from_start_state = Reachable(G, start_state);
-		for(int fs : final_states)
+		std::vector<bool> useful = Reachable(G, automaton_start_state.GetValue());
+		std::vector<bool> co_reachable = CoReachable(G, final_states);
+		for(uint32_t u = 0; u < G.Size(); ++u)
+		{
+			useful[ u ] = useful[ u ] && co_reachable[ u ];
+		}
+
+		return HasCycle(G, useful);
+	}
+
+	bool IsLanguageEmpty_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states)
+	{
+		std::vector<bool> reachable_from_start_state = Reachable(G, automaton_start_state.GetValue());
+		for(State fs : automaton_accepting_states)
 		{
-			if(reachable_from_start_state.find(fs) != reachable_from_start_state.end())
+			if(reachable_from_start_state[ fs.GetValue() ])
 			{
 				return false;
 			}
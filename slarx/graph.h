@@ -6,28 +6,56 @@
 #include <set>
 #include <utility>
 #include <tuple>
+#include <cstdint>
 
 // This file contains some useful graph algorithms used in the program
 
 namespace slarx
 {
-	// Typedef for a simple graph representation using an adjacency list
-	typedef std::vector<std::set<int> > DirectedGraph;
-	// Computes transpose of graph G
+	// Directed graph in compressed sparse row form. The successors of vertex u are stored contiguously in
+	// targets_[ offsets_[ u ] ] .. targets_[ offsets_[ u + 1 ] - 1 ], so traversals stream through two flat arrays
+	class DirectedGraph
+	{
+	public:
+		// Range of the successors of a vertex, usable in range-based for loops
+		struct Successors
+		{
+			const uint32_t* begin() const { return first; }
+			const uint32_t* end() const { return last; }
+			size_t size() const { return last - first; }
+			const uint32_t* first;
+			const uint32_t* last;
+		};
+
+		DirectedGraph() : offsets_(1, 0) { }
+		// Takes ownership of CSR arrays. offsets must have one entry per vertex plus a final entry equal to targets.size()
+		DirectedGraph(std::vector<uint32_t>&& offsets, std::vector<uint32_t>&& targets) : offsets_(std::move(offsets)), targets_(std::move(targets)) { }
+
+		uint32_t Size() const { return offsets_.size() - 1; }
+		size_t GetNumberOfEdges() const { return targets_.size(); }
+		Successors operator[](uint32_t u) const { return Successors{ targets_.data() + offsets_[ u ], targets_.data() + offsets_[ u + 1 ] }; }
+
+	private:
+		std::vector<uint32_t> offsets_;
+		std::vector<uint32_t> targets_;
+	};
+
+	// Computes transpose of graph G. The result uses the same CSR layout
 	DirectedGraph Transpose(const DirectedGraph& G);
-	/// Implements finding SCC using Kosaraju's algorithm
-	std::vector<std::set<int> > FindSCC(const DirectedGraph& G);
-
-	// Performs DFS on graph. Returns finish times on vertices
-	std::vector<int> DFS(const DirectedGraph& G);
-	// Auxillary function for DFS (this is the recursive part)
-	void DFS_Visit(int u, const DirectedGraph& G, std::vector<bool>& visited, std::vector<int>& finish_time, int& time);
-
-	// Performs DFS on G, but considers order specified by input vector
-	std::vector<std::set<int> > DFS2(const DirectedGraph& G, const std::vector<int>& order);
-	void DFS2_Visit(int u, std::set<int>& component, const DirectedGraph& G, std::vector<bool>& visited);
-	// Finds set of vertices, reachable from a start vertex
-	std::set<int> Reachable(const DirectedGraph& G, int start);
+	// Finds the strongly connected components of G with an iterative (explicit stack) version of Tarjan's algorithm in O(V + E).
+	// Components are returned in topological order, i.e. every component comes before all components reachable from it
+	std::vector<std::vector<uint32_t> > FindSCC(const DirectedGraph& G);
+	// Finds the vertices, reachable from a start vertex. reachable[ v ] is true if v is reachable
+	std::vector<bool> Reachable(const DirectedGraph& G, uint32_t start);
+	// Finds the vertices, from which any of the target vertices is reachable
+	std::vector<bool> CoReachable(const DirectedGraph& G, const std::vector<uint32_t>& targets);
+	// Marks vertices, which are not reachable from the start vertex, in the result of ImmediateDominators
+	const uint32_t kNoDominator = UINT32_MAX;
+	// Finds the immediate dominator of every vertex, i.e. the last vertex other than itself, which lies on every path from start to it,
+	// with the iterative algorithm of Cooper, Harvey and Kennedy. The start vertex is its own immediate dominator
+	std::vector<uint32_t> ImmediateDominators(const DirectedGraph& G, uint32_t start);
+	// Returns true if the subgraph of G induced by the vertices v with in_subgraph[ v ] == true contains a cycle
+	bool HasCycle(const DirectedGraph& G, const std::vector<bool>& in_subgraph);
 	// Auxilary function for the IsLanguageInfinite() Automaton function. Returns true if language is infinite and false otherwise
 	bool IsLanguageInfinite_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states);
 	bool IsLanguageEmpty_AUX(const DirectedGraph& G, State automaton_start_state, const std::set<State>& automaton_accepting_states);
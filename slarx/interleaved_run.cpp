@@ -0,0 +1,245 @@
+#include "interleaved_run.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SLARX_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// The SIMD kernels are compiled for their instruction sets regardless of the target of the rest of the
+// library and are only called after DetectInterleavedKernel has confirmed that the CPU supports them
+#if defined(SLARX_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SLARX_TARGET(features) __attribute__((target(features)))
+#else
+#define SLARX_TARGET(features)
+#endif
+
+namespace slarx
+{
+	namespace
+	{
+		// Advances every lane by steps characters. positions[ lane ] is the next character of the word in the lane
+		typedef void (*StepFunction)(const uint32_t* table, uint32_t columns, const uint32_t* classes, uint32_t* states, const char** positions, size_t steps);
+
+		template<size_t Lanes>
+		void ScalarStep(const uint32_t* table, uint32_t columns, const uint32_t* classes, uint32_t* states, const char** positions, size_t steps)
+		{
+			for(size_t k = 0; k < steps; ++k)
+			{
+				for(size_t lane = 0; lane < Lanes; ++lane)
+				{
+					states[ lane ] = table[ static_cast<size_t>(states[ lane ]) * columns + classes[ static_cast<unsigned char>(positions[ lane ][ k ]) ] ];
+				}
+			}
+			for(size_t lane = 0; lane < Lanes; ++lane)
+			{
+				positions[ lane ] += steps;
+			}
+		}
+
+#ifdef SLARX_X86
+		// Class of the k-th remaining character of a lane
+#define CLASS(lane) static_cast<int>(classes[ static_cast<unsigned char>(positions[ lane ][ k ]) ])
+
+		SLARX_TARGET("avx2")
+		void AVX2Step(const uint32_t* table, uint32_t columns, const uint32_t* classes, uint32_t* states, const char** positions, size_t steps)
+		{
+			const int* table_entries = reinterpret_cast<const int*>(table);
+			const __m256i width = _mm256_set1_epi32(static_cast<int>(columns));
+			__m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states));
+			for(size_t k = 0; k < steps; ++k)
+			{
+				const __m256i on = _mm256_setr_epi32(CLASS(0), CLASS(1), CLASS(2), CLASS(3), CLASS(4), CLASS(5), CLASS(6), CLASS(7));
+				__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(current, width), on);
+				current = _mm256_i32gather_epi32(table_entries, index, 4);
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(states), current);
+			for(size_t lane = 0; lane < 8; ++lane)
+			{
+				positions[ lane ] += steps;
+			}
+		}
+
+		SLARX_TARGET("avx512f")
+		void AVX512Step(const uint32_t* table, uint32_t columns, const uint32_t* classes, uint32_t* states, const char** positions, size_t steps)
+		{
+			const __m512i width = _mm512_set1_epi32(static_cast<int>(columns));
+			__m512i current = _mm512_loadu_si512(states);
+			for(size_t k = 0; k < steps; ++k)
+			{
+				const __m512i on = _mm512_setr_epi32(CLASS(0), CLASS(1), CLASS(2), CLASS(3), CLASS(4), CLASS(5), CLASS(6), CLASS(7),
+													 CLASS(8), CLASS(9), CLASS(10), CLASS(11), CLASS(12), CLASS(13), CLASS(14), CLASS(15));
+				__m512i index = _mm512_add_epi32(_mm512_mullo_epi32(current, width), on);
+				current = _mm512_mask_i32gather_epi32(current, 0xFFFF, index, table, 4);
+			}
+			_mm512_storeu_si512(states, current);
+			for(size_t lane = 0; lane < 16; ++lane)
+			{
+				positions[ lane ] += steps;
+			}
+		}
+#undef CLASS
+#endif
+
+		// Keeps Lanes words in flight. All lanes are advanced by the length of the shortest remaining word, after which
+		// the finished lanes take the next words. Once the words run out, the remaining lanes are finished one by one
+		template<size_t Lanes>
+		void RunLanes(const DFATransitionTable& table, uint32_t state, const std::string_view* words, size_t count, uint32_t* final_states, StepFunction step)
+		{
+			std::array<uint32_t, 256> classes;
+			for(size_t c = 0; c < 256; ++c)
+			{
+				classes[ c ] = table.GetByteClasses().Get(static_cast<char>(c));
+			}
+
+			// Lanes are advanced by the shortest of their words, so the words are taken in order of their length (counting sort,
+			// lengths from kLongWord up share a bucket). Lanes then mostly hold words of the same length and finish together
+			const size_t kLongWord = 64;
+			std::vector<size_t> bucket_offsets(kLongWord + 2, 0);
+			for(size_t i = 0; i < count; ++i)
+			{
+				++bucket_offsets[ std::min(words[ i ].size(), kLongWord) + 1 ];
+			}
+			for(size_t b = 1; b < bucket_offsets.size(); ++b)
+			{
+				bucket_offsets[ b ] += bucket_offsets[ b - 1 ];
+			}
+			std::vector<size_t> order(count);
+			for(size_t i = 0; i < count; ++i)
+			{
+				order[ bucket_offsets[ std::min(words[ i ].size(), kLongWord) ]++ ] = i;
+			}
+
+			alignas(64) uint32_t states[ Lanes ];
+			const char* positions[ Lanes ];
+			const char* ends[ Lanes ];
+			size_t word_of[ Lanes ];
+			size_t next_word = 0;
+			// Puts the next nonempty word into lane. Empty words are answered right away
+			auto take_next_word = [&](size_t lane) -> bool
+			{
+				for(; next_word < count; ++next_word)
+				{
+					const size_t word = order[ next_word ];
+					if(words[ word ].empty())
+					{
+						final_states[ word ] = state;
+						continue;
+					}
+					states[ lane ] = state;
+					positions[ lane ] = words[ word ].data();
+					ends[ lane ] = positions[ lane ] + words[ word ].size();
+					word_of[ lane ] = word;
+					++next_word;
+					return true;
+				}
+				return false;
+			};
+
+			size_t busy_lanes = 0;
+			while(busy_lanes < Lanes && take_next_word(busy_lanes))
+			{
+				++busy_lanes;
+			}
+			while(busy_lanes == Lanes)
+			{
+				size_t steps = ends[ 0 ] - positions[ 0 ];
+				for(size_t lane = 1; lane < Lanes; ++lane)
+				{
+					steps = std::min<size_t>(steps, ends[ lane ] - positions[ lane ]);
+				}
+				step(table.GetData(), table.GetNumberOfColumns(), classes.data(), states, positions, steps);
+
+				// Finished lanes are refilled and, once there are no more words, swapped behind the busy ones
+				for(size_t lane = 0; lane < busy_lanes;)
+				{
+					if(positions[ lane ] != ends[ lane ])
+					{
+						++lane;
+						continue;
+					}
+					final_states[ word_of[ lane ] ] = states[ lane ];
+					if(take_next_word(lane))
+					{
+						++lane;
+						continue;
+					}
+					--busy_lanes;
+					states[ lane ] = states[ busy_lanes ];
+					positions[ lane ] = positions[ busy_lanes ];
+					ends[ lane ] = ends[ busy_lanes ];
+					word_of[ lane ] = word_of[ busy_lanes ];
+				}
+			}
+
+			for(size_t lane = 0; lane < busy_lanes; ++lane)
+			{
+				final_states[ word_of[ lane ] ] = table.Run(states[ lane ], positions[ lane ], ends[ lane ]);
+			}
+		}
+	}
+
+	InterleavedKernel DetectInterleavedKernel()
+	{
+		static const InterleavedKernel kernel = []()
+		{
+#if defined(SLARX_X86) && defined(_MSC_VER)
+			int info[ 4 ];
+			__cpuid(info, 0);
+			const int max_leaf = info[ 0 ];
+			__cpuid(info, 1);
+			const bool os_saves_avx = (info[ 2 ] & (1 << 27)) != 0 && (info[ 2 ] & (1 << 28)) != 0;
+			if(!os_saves_avx || max_leaf < 7)
+				return InterleavedKernel::kScalar;
+			const unsigned long long enabled_state = _xgetbv(0);
+			__cpuidex(info, 7, 0);
+			if((enabled_state & 0xE6) == 0xE6 && (info[ 1 ] & (1 << 16)) != 0)
+				return InterleavedKernel::kAVX512;
+			if((enabled_state & 0x6) == 0x6 && (info[ 1 ] & (1 << 5)) != 0)
+				return InterleavedKernel::kAVX2;
+			return InterleavedKernel::kScalar;
+#elif defined(SLARX_X86)
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx512f"))
+				return InterleavedKernel::kAVX512;
+			if(__builtin_cpu_supports("avx2"))
+				return InterleavedKernel::kAVX2;
+			return InterleavedKernel::kScalar;
+#else
+			return InterleavedKernel::kScalar;
+#endif
+		}();
+		return kernel;
+	}
+
+	void InterleavedRun(const DFATransitionTable& table, uint32_t state, const std::string_view* words, size_t count, uint32_t* final_states, InterleavedKernel kernel)
+	{
+		// Gathers take signed 32-bit indices
+		const size_t number_of_entries = (static_cast<size_t>(table.GetSinkState()) + 1) * table.GetNumberOfColumns();
+		if(number_of_entries > INT32_MAX)
+		{
+			kernel = InterleavedKernel::kScalar;
+		}
+
+		switch(kernel)
+		{
+#ifdef SLARX_X86
+			case InterleavedKernel::kAVX512:
+				RunLanes<16>(table, state, words, count, final_states, AVX512Step);
+				break;
+			case InterleavedKernel::kAVX2:
+				RunLanes<8>(table, state, words, count, final_states, AVX2Step);
+				break;
+#endif
+			default:
+				RunLanes<8>(table, state, words, count, final_states, ScalarStep<8>);
+				break;
+		}
+	}
+}
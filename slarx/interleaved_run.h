@@ -0,0 +1,37 @@
+#pragma once
+#ifndef SLARX_INTERLEAVED_RUN_H_INCLUDED
+#define SLARX_INTERLEAVED_RUN_H_INCLUDED
+
+#include "dfa.h"
+#include <string_view>
+#include <cstdint>
+
+namespace slarx
+{
+	// Kernels of InterleavedRun. The SIMD kernels load the transitions of all lanes with one gather instruction
+	enum class InterleavedKernel
+	{
+		// 8 lanes in plain C++
+		kScalar,
+		// 8 lanes
+		kAVX2,
+		// 16 lanes
+		kAVX512
+	};
+
+	// Tables smaller than this stay in the caches, where a single word runs faster on its own than the lanes can be managed,
+	// so RecognizeBatch runs words one by one for them
+	const size_t kMinimalInterleavedTableSize = 4 << 20;
+
+	// Returns the widest kernel the CPU and the operating system support. The CPU is queried only once
+	InterleavedKernel DetectInterleavedKernel();
+
+	// Runs the finalized table on count words starting from state and stores the reached rows in final_states.
+	// Running a single word is a chain of dependent loads, so the words are assigned to lanes, which are advanced
+	// in lockstep, keeping several loads from the table in flight. A lane takes the next word when its word ends.
+	// Falls back to the scalar kernel if the table is too large for 32-bit gather indices
+	void InterleavedRun(const DFATransitionTable& table, uint32_t state, const std::string_view* words, size_t count, uint32_t* final_states,
+						InterleavedKernel kernel = DetectInterleavedKernel());
+}
+
+#endif // SLARX_INTERLEAVED_RUN_H_INCLUDED
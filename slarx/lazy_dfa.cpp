@@ -0,0 +1,144 @@
+#include "lazy_dfa.h"
+
+#include <algorithm>
+
+namespace slarx
+{
+	const size_t LazyDFA::kDefaultCacheSize;
+	const uint32_t LazyDFA::kUnknownTransition;
+
+	namespace
+	{
+		Alphabet WithoutEpsilon(Alphabet alphabet)
+		{
+			alphabet.RemoveCharacter(kEpsilon);
+			return alphabet;
+		}
+	}
+
+	LazyDFA::LazyDFA(const ConversionNFA& nfa, size_t cache_size)
+		: alphabet_(WithoutEpsilon(nfa.GetAlphabet())), classes_(nfa.GetTransitionTable().ComputeByteClasses(alphabet_)),
+		number_of_columns_(classes_.Size()), epsilon_closures_(nfa.GetTransitionTable(), nfa.Size()),
+		number_of_words_(epsilon_closures_.GetNumberOfWords()), nfa_accepting_states_(number_of_words_, 0), nfa_start_set_(number_of_words_, 0),
+		start_state_(0), dead_state_(0), number_of_flushes_(0)
+	{
+		// Class 0 holds the characters outside of the alphabet, so it never has transitions
+		std::vector<char> class_representatives = classes_.GetRepresentatives();
+		class_offsets_.reserve(static_cast<size_t>(nfa.Size()) * number_of_columns_ + 1);
+		class_offsets_.push_back(0);
+		for(uint32_t from = 0; from < nfa.Size(); ++from)
+		{
+			class_offsets_.push_back(class_targets_.size());
+			for(size_t k = 1; k < number_of_columns_; ++k)
+			{
+				for(State to : nfa.GetTransitionTable().GetTransition(State(from), class_representatives[ k - 1 ]))
+				{
+					class_targets_.push_back(to.GetValue());
+				}
+				class_offsets_.push_back(class_targets_.size());
+			}
+		}
+
+		for(State s : nfa.GetAcceptingStates())
+		{
+			nfa_accepting_states_[ s.GetValue() / 64 ] |= uint64_t(1) << (s.GetValue() % 64);
+		}
+		epsilon_closures_.AddClosure(nfa.GetStartState().GetValue(), nfa_start_set_.data());
+
+		// A cached state costs its bit row, its row of transitions and roughly the overhead of a hash map node
+		const size_t state_size = number_of_words_ * sizeof(uint64_t) + number_of_columns_ * sizeof(uint32_t) + 64;
+		cache_capacity_ = static_cast<uint32_t>(std::min<size_t>(std::max<size_t>(cache_size / state_size, 4), kUnknownTransition - 1));
+
+		Flush();
+	}
+
+	bool LazyDFA::Recognize(const char* data, size_t size) const
+	{
+		uint32_t state = start_state_;
+		for(const char* end = data + size; data != end; ++data)
+		{
+			ByteClasses::Class class_id = classes_.Get(*data);
+			uint32_t next = cached_transitions_[ static_cast<size_t>(state) * number_of_columns_ + class_id ];
+			if(next == kUnknownTransition)
+			{
+				next = ComputeTransition(state, class_id);
+			}
+			state = next;
+			if(state == dead_state_)
+				return false;
+		}
+
+		return cached_accepting_[ state ] != 0;
+	}
+
+	uint32_t LazyDFA::ComputeTransition(uint32_t state, ByteClasses::Class class_id) const
+	{
+		std::vector<uint64_t> target(number_of_words_, 0);
+		ForEachSetBit(cached_sets_[ state ]->data(), number_of_words_, [&](uint32_t s)
+		{
+			const size_t row = static_cast<size_t>(s) * number_of_columns_ + class_id;
+			for(uint32_t i = class_offsets_[ row ]; i < class_offsets_[ row + 1 ]; ++i)
+			{
+				epsilon_closures_.AddClosure(class_targets_[ i ], target.data());
+			}
+		});
+
+		const uint64_t flushes = number_of_flushes_;
+		uint32_t next = FindOrAddState(std::move(target));
+		if(flushes == number_of_flushes_)
+		{
+			cached_transitions_[ static_cast<size_t>(state) * number_of_columns_ + class_id ] = next;
+		}
+		return next;
+	}
+
+	uint32_t LazyDFA::FindOrAddState(std::vector<uint64_t>&& nfa_states) const
+	{
+		auto found = cached_state_index_.find(nfa_states);
+		if(found != cached_state_index_.end())
+			return found->second;
+
+		if(cached_sets_.size() >= cache_capacity_)
+		{
+			Flush();
+			++number_of_flushes_;
+			found = cached_state_index_.find(nfa_states);
+			if(found != cached_state_index_.end())
+				return found->second;
+		}
+
+		auto inserted = cached_state_index_.insert(std::make_pair(std::move(nfa_states), static_cast<uint32_t>(cached_sets_.size())));
+		const std::vector<uint64_t>& key = inserted.first->first;
+		bool is_accepting = false;
+		for(uint32_t w = 0; w < number_of_words_; ++w)
+		{
+			if(key[ w ] & nfa_accepting_states_[ w ])
+			{
+				is_accepting = true;
+				break;
+			}
+		}
+		cached_sets_.push_back(&key);
+		cached_accepting_.push_back(is_accepting);
+		cached_transitions_.resize(cached_transitions_.size() + number_of_columns_, kUnknownTransition);
+		// Characters outside of the alphabet lead to the dead state
+		cached_transitions_[ cached_transitions_.size() - number_of_columns_ ] = dead_state_;
+
+		return inserted.first->second;
+	}
+
+	void LazyDFA::Flush() const
+	{
+		cached_state_index_.clear();
+		cached_sets_.clear();
+		cached_transitions_.clear();
+		cached_accepting_.clear();
+
+		start_state_ = FindOrAddState(std::vector<uint64_t>(nfa_start_set_));
+		dead_state_ = FindOrAddState(std::vector<uint64_t>(number_of_words_, 0));
+		for(uint32_t state = 0; state < cached_sets_.size(); ++state)
+		{
+			cached_transitions_[ static_cast<size_t>(state) * number_of_columns_ ] = dead_state_;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef SLARX_LAZY_DFA_H_INCLUDED
+#define SLARX_LAZY_DFA_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "utility.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+namespace slarx
+{
+	// Recognizes words of a ConversionNFA without converting it to a DFA up front. DFA states (epsilon closed sets
+	// of NFA states) are created only when the input reaches them and their transitions are filled in on first use.
+	// The states are kept in a cache, which is bounded by a memory budget and is flushed completely when it is full,
+	// so an NFA with an exponential powerset construction can still be queried at almost the speed of a DFA.
+	// Recognize updates the cache, so a LazyDFA must not be shared between threads
+	class LazyDFA
+	{
+	public:
+		static const size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+		// cache_size is the approximate number of bytes the cached DFA states may occupy
+		explicit LazyDFA(const ConversionNFA& nfa, size_t cache_size = kDefaultCacheSize);
+		explicit LazyDFA(const std::string& path, size_t cache_size = kDefaultCacheSize) : LazyDFA(ConversionNFA(path), cache_size) { }
+
+		// Returns true if word is in the language of the NFA and false otherwise
+		bool Recognize(std::string& word) const { return Recognize(word.data(), word.size()); }
+		bool Recognize(const char* data, size_t size) const;
+
+		const Alphabet& GetAlphabet() const { return alphabet_; }
+		uint32_t GetNumberOfCachedStates() const { return static_cast<uint32_t>(cached_sets_.size()); }
+		// Maximal number of states the cache holds before it is flushed
+		uint32_t GetCacheCapacity() const { return cache_capacity_; }
+		// Number of times the cache was full and was flushed
+		uint64_t GetNumberOfFlushes() const { return number_of_flushes_; }
+
+	private:
+		static const uint32_t kUnknownTransition = UINT32_MAX;
+
+		// Computes the target of the transition from cached state on class_id, adding it to the cache if needed.
+		// If the cache is flushed in the process, state is no longer valid and only the returned state is
+		uint32_t ComputeTransition(uint32_t state, ByteClasses::Class class_id) const;
+		// Returns the cached state for the epsilon closed set of NFA states or adds it, flushing the cache if it is full
+		uint32_t FindOrAddState(std::vector<uint64_t>&& nfa_states) const;
+		// Empties the cache and adds the start state and the dead state (the empty set) again
+		void Flush() const;
+
+		Alphabet alphabet_;
+		ByteClasses classes_;
+		uint32_t number_of_columns_;
+		EpsilonClosureTable epsilon_closures_;
+		uint32_t number_of_words_;
+		// Targets of the NFA transitions from state s on class k are
+		// class_targets_[ class_offsets_[ s * columns + k ] .. class_offsets_[ s * columns + k + 1 ] )
+		std::vector<uint32_t> class_offsets_;
+		std::vector<uint32_t> class_targets_;
+		std::vector<uint64_t> nfa_accepting_states_;
+		std::vector<uint64_t> nfa_start_set_;
+		uint32_t cache_capacity_;
+
+		// The cache. State i is the set of NFA states *cached_sets_[ i ] (a key of cached_state_index_), its
+		// row of transitions starts at cached_transitions_[ i * number_of_columns_ ]
+		mutable std::unordered_map<std::vector<uint64_t>, uint32_t, ContainerHash> cached_state_index_;
+		mutable std::vector<const std::vector<uint64_t>*> cached_sets_;
+		mutable std::vector<uint32_t> cached_transitions_;
+		mutable std::vector<uint8_t> cached_accepting_;
+		mutable uint32_t start_state_;
+		mutable uint32_t dead_state_;
+		mutable uint64_t number_of_flushes_;
+	};
+}
+
+#endif // SLARX_LAZY_DFA_H_INCLUDED
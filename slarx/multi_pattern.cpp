@@ -0,0 +1,290 @@
+#include "multi_pattern.h"
+#include "graph.h"
+
+#include <algorithm>
+#include <array>
+
+namespace slarx
+{
+	const size_t MultiPatternScanner::kDefaultCacheSize;
+	const uint32_t MultiPatternScanner::kUnknownTransition;
+	const uint32_t MultiPatternScanner::kDead;
+	const uint32_t MultiPatternScanner::kEndOfGroup;
+	const uint32_t MultiPatternScanner::kMatched;
+	const uint8_t MultiPatternScanner::kFinal;
+
+	MultiPatternScanner::MultiPatternScanner(const std::vector<const DFA*>& automata, ScanKind kind, size_t cache_size)
+		: kind_(kind), number_of_flushes_(0)
+	{
+		// A character is in class 0 only if it is outside of every alphabet. The other classes are split, until every
+		// class lies inside of a single class of every DFA
+		std::array<ByteClasses::Class, 256> in_some_alphabet;
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			in_some_alphabet[ c ] = 0;
+			for(const DFA* dfa : automata)
+			{
+				if(dfa->GetTransitionTable().GetByteClasses().Get(static_cast<char>(c)) != 0)
+				{
+					in_some_alphabet[ c ] = 1;
+					break;
+				}
+			}
+		}
+		classes_ = ByteClasses(in_some_alphabet);
+		for(const DFA* dfa : automata)
+		{
+			classes_.Refine(dfa->GetTransitionTable().GetByteClasses());
+		}
+		number_of_columns_ = classes_.Size();
+		std::vector<char> class_representatives = classes_.GetRepresentatives();
+
+		for(const DFA* dfa : automata)
+		{
+			Component component{ static_cast<uint32_t>(dfa->GetIdentifier().GetValue()), dfa->GetTransitionTable(), static_cast<uint32_t>(dfa->GetStartState().GetValue()),
+								 dfa->GetAcceptingLookup(), std::vector<uint8_t>(), std::vector<ByteClasses::Class>(number_of_columns_, 0) };
+			const uint32_t number_of_states = component.table.GetSinkState();
+			std::vector<uint32_t> accepting_states;
+			for(uint32_t s = 0; s < number_of_states; ++s)
+			{
+				if(component.accepting_lookup[ s ])
+				{
+					accepting_states.push_back(s);
+				}
+			}
+			std::vector<bool> can_accept = CoReachable(component.table.GetGraph(), accepting_states);
+			component.live.assign(number_of_states + 1, 0);
+			for(uint32_t s = 0; s < number_of_states; ++s)
+			{
+				component.live[ s ] = can_accept[ s ];
+			}
+			for(uint32_t k = 1; k < number_of_columns_; ++k)
+			{
+				component.class_of[ k ] = component.table.GetByteClasses().Get(class_representatives[ k - 1 ]);
+			}
+			components_.push_back(std::move(component));
+		}
+
+		// A cached state costs its key, its tags, its row of transitions and roughly the overhead of a hash map node
+		const size_t state_size = number_of_columns_ * sizeof(uint32_t) + components_.size() * 2 * sizeof(uint32_t) + 128;
+		cache_capacity_ = static_cast<uint32_t>(std::min<size_t>(std::max<size_t>(cache_size / state_size, 4), kUnknownTransition - 1));
+		Flush();
+	}
+
+	std::vector<uint32_t> MultiPatternScanner::InitialKey() const
+	{
+		std::vector<uint32_t> key;
+		for(const Component& component : components_)
+		{
+			const bool live = component.live[ component.start_state ] != 0;
+			if(kind_ == ScanKind::kAccept)
+			{
+				key.push_back(live ? component.start_state : kDead);
+				continue;
+			}
+			// An automaton, which accepts the empty word, matches before the first character
+			if(component.accepting_lookup[ component.start_state ])
+			{
+				key.push_back(kMatched);
+			}
+			else if(live)
+			{
+				key.push_back(component.start_state);
+			}
+			key.push_back(kEndOfGroup);
+		}
+		return key;
+	}
+
+	uint32_t MultiPatternScanner::Transition(uint32_t state, ByteClasses::Class class_id) const
+	{
+		uint32_t next = cached_transitions_[ static_cast<size_t>(state) * number_of_columns_ + class_id ];
+		if(next == kUnknownTransition)
+		{
+			next = ComputeTransition(state, class_id);
+		}
+		return next;
+	}
+
+	uint32_t MultiPatternScanner::ComputeTransition(uint32_t state, ByteClasses::Class class_id) const
+	{
+		const std::vector<uint32_t>& key = *cached_keys_[ state ];
+		std::vector<uint32_t> next_key;
+		next_key.reserve(key.size());
+		if(kind_ == ScanKind::kAccept)
+		{
+			for(size_t i = 0; i < components_.size(); ++i)
+			{
+				const Component& component = components_[ i ];
+				uint32_t to = kDead;
+				if(key[ i ] != kDead)
+				{
+					to = component.table.GetClassTransition(key[ i ], component.class_of[ class_id ]);
+					to = component.live[ to ] ? to : kDead;
+				}
+				next_key.push_back(to);
+			}
+		}
+		else
+		{
+			// Every run of a DFA takes the transition and a new run is started after the character, unless the DFA matched
+			size_t position = 0;
+			for(const Component& component : components_)
+			{
+				if(key[ position ] == kMatched)
+				{
+					next_key.push_back(kMatched);
+					next_key.push_back(kEndOfGroup);
+					position += 2;
+					continue;
+				}
+
+				const size_t group_begin = next_key.size();
+				bool matched = false;
+				for(; key[ position ] != kEndOfGroup; ++position)
+				{
+					const uint32_t to = component.table.GetClassTransition(key[ position ], component.class_of[ class_id ]);
+					if(component.live[ to ])
+					{
+						next_key.push_back(to);
+						matched = matched || component.accepting_lookup[ to ];
+					}
+				}
+				++position;
+				if(matched)
+				{
+					next_key.resize(group_begin);
+					next_key.push_back(kMatched);
+				}
+				else
+				{
+					if(component.live[ component.start_state ])
+					{
+						next_key.push_back(component.start_state);
+					}
+					std::sort(next_key.begin() + group_begin, next_key.end());
+					next_key.erase(std::unique(next_key.begin() + group_begin, next_key.end()), next_key.end());
+				}
+				next_key.push_back(kEndOfGroup);
+			}
+		}
+
+		const uint64_t flushes = number_of_flushes_;
+		uint32_t next = FindOrAddState(std::move(next_key));
+		if(flushes == number_of_flushes_)
+		{
+			cached_transitions_[ static_cast<size_t>(state) * number_of_columns_ + class_id ] = next;
+		}
+		return next;
+	}
+
+	uint32_t MultiPatternScanner::FindOrAddState(std::vector<uint32_t>&& key) const
+	{
+		auto found = cached_state_index_.find(key);
+		if(found != cached_state_index_.end())
+			return found->second;
+
+		if(cached_keys_.size() >= cache_capacity_)
+		{
+			Flush();
+			++number_of_flushes_;
+			found = cached_state_index_.find(key);
+			if(found != cached_state_index_.end())
+				return found->second;
+		}
+
+		auto inserted = cached_state_index_.insert(std::make_pair(std::move(key), static_cast<uint32_t>(cached_keys_.size())));
+		const std::vector<uint32_t>& stored_key = inserted.first->first;
+		// The tags of a kAccept state are final once every DFA is dead. A kMatch state is final once every DFA either
+		// matched or has no runs, because it can never start one
+		bool is_final = true;
+		size_t position = 0;
+		for(uint32_t i = 0; i < components_.size(); ++i)
+		{
+			const Component& component = components_[ i ];
+			if(kind_ == ScanKind::kAccept)
+			{
+				const uint32_t s = stored_key[ i ];
+				if(s != kDead && component.accepting_lookup[ s ])
+				{
+					cached_tags_.push_back(i);
+				}
+				is_final = is_final && s == kDead;
+				continue;
+			}
+
+			if(stored_key[ position ] == kMatched)
+			{
+				cached_tags_.push_back(i);
+			}
+			else
+			{
+				is_final = is_final && stored_key[ position ] == kEndOfGroup && !component.live[ component.start_state ];
+			}
+			position = std::find(stored_key.begin() + position, stored_key.end(), kEndOfGroup) - stored_key.begin() + 1;
+		}
+
+		cached_keys_.push_back(&stored_key);
+		cached_tag_offsets_.push_back(static_cast<uint32_t>(cached_tags_.size()));
+		cached_flags_.push_back(is_final ? kFinal : 0);
+		cached_transitions_.resize(cached_transitions_.size() + number_of_columns_, kUnknownTransition);
+
+		return inserted.first->second;
+	}
+
+	void MultiPatternScanner::Flush() const
+	{
+		cached_state_index_.clear();
+		cached_keys_.clear();
+		cached_tag_offsets_.assign(1, 0);
+		cached_tags_.clear();
+		cached_transitions_.clear();
+		cached_flags_.clear();
+
+		initial_state_ = FindOrAddState(InitialKey());
+	}
+
+	void MultiPatternScanner::Scan(const char* data, size_t size, const std::function<bool(uint32_t, size_t)>& on_match) const
+	{
+		uint32_t state = initial_state_;
+		// For kMatch a DFA stays matched, so the tags of a state are reported when their number grows
+		std::vector<uint8_t> reported(components_.size(), 0);
+		uint32_t number_of_reported = 0;
+		auto report_new_tags = [&](size_t end) -> bool
+		{
+			for(uint32_t t = cached_tag_offsets_[ state ]; t < cached_tag_offsets_[ state + 1 ]; ++t)
+			{
+				const uint32_t component = cached_tags_[ t ];
+				if(reported[ component ])
+					continue;
+				reported[ component ] = 1;
+				++number_of_reported;
+				if(!on_match(components_[ component ].id, end))
+					return false;
+			}
+			return true;
+		};
+
+		const bool report_early = kind_ == ScanKind::kMatch;
+		if(report_early && !report_new_tags(0))
+			return;
+		for(size_t i = 0; i < size && !(cached_flags_[ state ] & kFinal); ++i)
+		{
+			state = Transition(state, classes_.Get(data[ i ]));
+			if(report_early && cached_tag_offsets_[ state + 1 ] - cached_tag_offsets_[ state ] > number_of_reported && !report_new_tags(i + 1))
+				return;
+		}
+		if(!report_early)
+		{
+			report_new_tags(size);
+		}
+	}
+
+	std::vector<uint32_t> MultiPatternScanner::Scan(const char* data, size_t size) const
+	{
+		std::vector<uint32_t> identifiers;
+		Scan(data, size, [&identifiers](uint32_t id, size_t) { identifiers.push_back(id); return true; });
+		std::sort(identifiers.begin(), identifiers.end());
+		return identifiers;
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef SLARX_MULTI_PATTERN_H_INCLUDED
+#define SLARX_MULTI_PATTERN_H_INCLUDED
+
+#include "dfa.h"
+#include "utility.h"
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace slarx
+{
+	enum class ScanKind
+	{
+		// Reports the automata, which accept the whole input
+		kAccept,
+		// Reports the automata, which accept some substring of the input
+		kMatch
+	};
+
+	// Scans an input once for any number of DFAs, instead of once per DFA. The DFAs are combined into a product
+	// automaton, whose states are tagged with the DFAs accepting in them. The product states are built lazily from the
+	// states of the DFAs, which the input reaches, and kept in a cache, which is bounded by a memory budget and flushed
+	// completely when it is full. The DFAs are copied, so they may be deleted afterwards.
+	// Scanning updates the cache, so a MultiPatternScanner must not be shared between threads
+	class MultiPatternScanner
+	{
+	public:
+		static const size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+		// cache_size is the approximate number of bytes the cached states may occupy
+		explicit MultiPatternScanner(const std::vector<const DFA*>& automata, ScanKind kind = ScanKind::kMatch, size_t cache_size = kDefaultCacheSize);
+
+		// Returns the sorted identifiers of the automata, which accept [data, data + size) (for kAccept) or a substring of it (for kMatch)
+		std::vector<uint32_t> Scan(const char* data, size_t size) const;
+		// Calls on_match(id, end) for the automata reported by Scan. For kMatch the call is made as soon as the automaton first matches,
+		// with end being the end of its first match. For kAccept end is always size. The scan stops early if on_match returns false
+		void Scan(const char* data, size_t size, const std::function<bool(uint32_t, size_t)>& on_match) const;
+
+		ScanKind GetScanKind() const { return kind_; }
+		uint32_t GetNumberOfAutomata() const { return static_cast<uint32_t>(components_.size()); }
+		uint32_t GetNumberOfCachedStates() const { return static_cast<uint32_t>(cached_keys_.size()); }
+		// Maximal number of states the cache holds before it is flushed
+		uint32_t GetCacheCapacity() const { return cache_capacity_; }
+		// Number of times the cache was full and was flushed
+		uint64_t GetNumberOfFlushes() const { return number_of_flushes_; }
+
+	private:
+		static const uint32_t kUnknownTransition = UINT32_MAX;
+		// For kAccept, the state of a DFA, from which no accepting state is reachable
+		static const uint32_t kDead = UINT32_MAX;
+		// For kMatch, ends the states of a DFA in the representation of a state
+		static const uint32_t kEndOfGroup = UINT32_MAX;
+		// For kMatch, replaces the states of a DFA, which already matched
+		static const uint32_t kMatched = UINT32_MAX - 1;
+		// Flag of a cached state, whose tags can no longer change
+		static const uint8_t kFinal = 1;
+
+		// One of the combined DFAs
+		struct Component
+		{
+			uint32_t id;
+			DFATransitionTable table;
+			uint32_t start_state;
+			std::vector<uint8_t> accepting_lookup;
+			// live[ s ] is 1 if an accepting state is reachable from s
+			std::vector<uint8_t> live;
+			// Maps the classes of the scanner to the classes of the DFA
+			std::vector<ByteClasses::Class> class_of;
+		};
+
+		// Returns the cached state, which the cached state state goes to on class_id, computing and caching it if needed.
+		// If the cache is flushed, state is no longer valid and only the returned state is
+		uint32_t Transition(uint32_t state, ByteClasses::Class class_id) const;
+		uint32_t ComputeTransition(uint32_t state, ByteClasses::Class class_id) const;
+		uint32_t FindOrAddState(std::vector<uint32_t>&& key) const;
+		void Flush() const;
+		std::vector<uint32_t> InitialKey() const;
+
+		ScanKind kind_;
+		std::vector<Component> components_;
+		ByteClasses classes_;
+		uint32_t number_of_columns_;
+		uint32_t cache_capacity_;
+
+		// The cache. State i is described by *cached_keys_[ i ] (a key of cached_state_index_), which holds the state of every DFA
+		// (for kAccept) or the states of the runs of every DFA, each ended by kEndOfGroup (for kMatch). The indices of the components
+		// accepting in state i are cached_tags_[ cached_tag_offsets_[ i ] .. cached_tag_offsets_[ i + 1 ] ), its row of transitions
+		// starts at cached_transitions_[ i * number_of_columns_ ]
+		mutable std::unordered_map<std::vector<uint32_t>, uint32_t, ContainerHash> cached_state_index_;
+		mutable std::vector<const std::vector<uint32_t>*> cached_keys_;
+		mutable std::vector<uint32_t> cached_tag_offsets_;
+		mutable std::vector<uint32_t> cached_tags_;
+		mutable std::vector<uint32_t> cached_transitions_;
+		mutable std::vector<uint8_t> cached_flags_;
+		mutable uint32_t initial_state_;
+		mutable uint64_t number_of_flushes_;
+	};
+}
+
+#endif // SLARX_MULTI_PATTERN_H_INCLUDED
@@ -0,0 +1,54 @@
+#include "nfa_recognizer.h"
+
+#include <stdexcept>
+
+namespace slarx
+{
+	NFARecognizer::NFARecognizer(ConversionNFA& nfa, RecognitionEngine engine) : engine_(engine)
+	{
+		if(engine_ == RecognitionEngine::kAutomatic)
+		{
+			engine_ = nfa.Size() <= BitParallelNFA::kMaxStates ? RecognitionEngine::kBitParallel : RecognitionEngine::kLazyDFA;
+		}
+
+		switch(engine_)
+		{
+			case RecognitionEngine::kDFA:
+				dfa_.reset(new DFA(nfa.ToDFA(false), false));
+				break;
+			case RecognitionEngine::kLazyDFA:
+				lazy_dfa_.reset(new LazyDFA(nfa));
+				break;
+			default:
+				bit_parallel_nfa_.reset(new BitParallelNFA(nfa));
+				break;
+		}
+	}
+
+	bool NFARecognizer::Recognize(const char* data, size_t size) const
+	{
+		switch(engine_)
+		{
+			case RecognitionEngine::kDFA:
+				return dfa_->Recognize(data, size);
+			case RecognitionEngine::kLazyDFA:
+				return lazy_dfa_->Recognize(data, size);
+			default:
+				return bit_parallel_nfa_->Recognize(data, size);
+		}
+	}
+
+	RecognitionEngine ParseRecognitionEngine(const std::string& name)
+	{
+		if(name == "auto")
+			return RecognitionEngine::kAutomatic;
+		else if(name == "dfa")
+			return RecognitionEngine::kDFA;
+		else if(name == "lazy")
+			return RecognitionEngine::kLazyDFA;
+		else if(name == "bits")
+			return RecognitionEngine::kBitParallel;
+		else
+			throw(std::invalid_argument("Unknown recognition engine " + name + " (should be auto, dfa, lazy or bits)"));
+	}
+}
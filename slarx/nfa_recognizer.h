@@ -0,0 +1,48 @@
+#pragma once
+#ifndef SLARX_NFA_RECOGNIZER_H_INCLUDED
+#define SLARX_NFA_RECOGNIZER_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "lazy_dfa.h"
+#include "bit_parallel_nfa.h"
+#include <memory>
+#include <string>
+
+namespace slarx
+{
+	// The ways an NFA can be matched against words
+	enum class RecognitionEngine
+	{
+		// Bit-parallel simulation if the NFA is small enough and lazy determinization otherwise
+		kAutomatic,
+		// Full powerset construction with ConversionNFA::ToDFA
+		kDFA,
+		kLazyDFA,
+		kBitParallel
+	};
+
+	// Recognizes words of a ConversionNFA with one of the engines above, chosen once at construction
+	class NFARecognizer
+	{
+	public:
+		// Throws std::invalid_argument if kBitParallel is requested for an NFA with too many states
+		explicit NFARecognizer(ConversionNFA& nfa, RecognitionEngine engine = RecognitionEngine::kAutomatic);
+
+		bool Recognize(std::string& word) const { return Recognize(word.data(), word.size()); }
+		bool Recognize(const char* data, size_t size) const;
+
+		// The engine in use. Never kAutomatic
+		RecognitionEngine GetEngine() const { return engine_; }
+
+	private:
+		RecognitionEngine engine_;
+		std::unique_ptr<DFA> dfa_;
+		std::unique_ptr<LazyDFA> lazy_dfa_;
+		std::unique_ptr<BitParallelNFA> bit_parallel_nfa_;
+	};
+
+	// Parses the name of an engine ("auto", "dfa", "lazy" or "bits"). Throws std::invalid_argument for other names
+	RecognitionEngine ParseRecognitionEngine(const std::string& name);
+}
+
+#endif // SLARX_NFA_RECOGNIZER_H_INCLUDED
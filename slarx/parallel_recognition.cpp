@@ -0,0 +1,131 @@
+#include "parallel_recognition.h"
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+namespace slarx
+{
+	namespace
+	{
+		// Runs are merged after blocks of input, which grow from kFirstBlockSize to kLastBlockSize bytes
+		const size_t kFirstBlockSize = 64;
+		const size_t kLastBlockSize = 1 << 16;
+
+		// Maps every candidate starting state of a chunk to the state, which is reached at the end of the chunk
+		struct ChunkMap
+		{
+			// Sorted and distinct
+			std::vector<uint32_t> starts;
+			std::vector<uint32_t> finals;
+		};
+
+		// Fills map.finals for the candidates in map.starts. Runs, which reach the same state at the end of a block,
+		// are merged. Every merge is recorded as a map from the old to the new indices of the runs, and the maps are
+		// composed in reverse at the end, so following a run costs nothing after it is merged
+		void RunChunk(const DFATransitionTable& table, const char* begin, const char* end, ChunkMap& map)
+		{
+			std::vector<uint32_t> runs = map.starts;
+			std::vector<std::vector<uint32_t> > merges;
+			// run_of[ state ] is the index of the run, which is in state, during a merge
+			std::vector<uint32_t> run_of(table.GetSinkState() + 1, UINT32_MAX);
+			size_t block_size = kFirstBlockSize;
+			while(begin != end)
+			{
+				const char* block_end = runs.size() == 1 ? end : begin + std::min<size_t>(block_size, end - begin);
+				for(uint32_t& state : runs)
+				{
+					state = table.Run(state, begin, block_end);
+				}
+				begin = block_end;
+				block_size = std::min(block_size * 2, kLastBlockSize);
+
+				std::vector<uint32_t> merge(runs.size());
+				uint32_t number_of_runs = 0;
+				for(uint32_t i = 0; i < runs.size(); ++i)
+				{
+					if(run_of[ runs[ i ] ] == UINT32_MAX)
+					{
+						run_of[ runs[ i ] ] = number_of_runs;
+						runs[ number_of_runs++ ] = runs[ i ];
+					}
+					merge[ i ] = run_of[ runs[ i ] ];
+				}
+				for(uint32_t i = 0; i < number_of_runs; ++i)
+				{
+					run_of[ runs[ i ] ] = UINT32_MAX;
+				}
+				if(number_of_runs < runs.size())
+				{
+					runs.resize(number_of_runs);
+					merges.push_back(std::move(merge));
+				}
+			}
+
+			for(size_t m = merges.size(); m-- > 0;)
+			{
+				std::vector<uint32_t> previous_runs(merges[ m ].size());
+				for(size_t i = 0; i < previous_runs.size(); ++i)
+				{
+					previous_runs[ i ] = runs[ merges[ m ][ i ] ];
+				}
+				runs.swap(previous_runs);
+			}
+			map.finals = std::move(runs);
+		}
+	}
+
+	uint32_t ParallelRun(const DFATransitionTable& table, uint32_t state, const char* begin, const char* end, unsigned number_of_threads)
+	{
+		if(number_of_threads == 0)
+		{
+			number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		const size_t size = end - begin;
+		const size_t number_of_chunks = std::min<size_t>(number_of_threads, size / kMinimalParallelChunkSize);
+		if(number_of_chunks <= 1)
+		{
+			return table.Run(state, begin, end);
+		}
+
+		// The state at the start of chunk i is the target of some transition on the last character of chunk i - 1
+		std::vector<const char*> boundaries(number_of_chunks + 1);
+		for(size_t i = 0; i <= number_of_chunks; ++i)
+		{
+			boundaries[ i ] = begin + size / number_of_chunks * i;
+		}
+		boundaries[ number_of_chunks ] = end;
+		std::vector<ChunkMap> maps(number_of_chunks);
+		std::vector<std::thread> threads;
+		for(size_t i = 1; i < number_of_chunks; ++i)
+		{
+			const ByteClasses::Class on = table.GetByteClasses().Get(boundaries[ i ][ -1 ]);
+			for(uint32_t from = 0; from <= table.GetSinkState(); ++from)
+			{
+				maps[ i ].starts.push_back(table.GetClassTransition(from, on));
+			}
+			std::sort(maps[ i ].starts.begin(), maps[ i ].starts.end());
+			maps[ i ].starts.erase(std::unique(maps[ i ].starts.begin(), maps[ i ].starts.end()), maps[ i ].starts.end());
+			threads.emplace_back(RunChunk, std::cref(table), boundaries[ i ], boundaries[ i + 1 ], std::ref(maps[ i ]));
+		}
+
+		state = table.Run(state, boundaries[ 0 ], boundaries[ 1 ]);
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		for(size_t i = 1; i < number_of_chunks; ++i)
+		{
+			const size_t index = std::lower_bound(maps[ i ].starts.begin(), maps[ i ].starts.end(), state) - maps[ i ].starts.begin();
+			state = maps[ i ].finals[ index ];
+		}
+		return state;
+	}
+
+	bool RecognizeParallel(const DFA& dfa, const char* data, size_t size, unsigned number_of_threads)
+	{
+		uint32_t final_state = ParallelRun(dfa.GetTransitionTable(), dfa.GetStartState().GetValue(), data, data + size, number_of_threads);
+		return dfa.GetAcceptingLookup()[ final_state ] != 0;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#ifndef SLARX_PARALLEL_RECOGNITION_H_INCLUDED
+#define SLARX_PARALLEL_RECOGNITION_H_INCLUDED
+
+#include "dfa.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace slarx
+{
+	// Inputs shorter than this are not split, because starting threads would cost more than running them
+	const size_t kMinimalParallelChunkSize = 1 << 20;
+
+	// Runs the finalized table on [begin, end) starting from state, like DFATransitionTable::Run, but splits the input into
+	// chunks, which are processed on separate threads. The state at the start of a chunk is not known in advance, so every
+	// chunk but the first is run from all states its preceding character can lead to. Runs, which reach the same state,
+	// are merged, so after a short prefix only a few distinct states are followed. The per-chunk maps from starting to
+	// final states are then composed in order to get the exact final state.
+	// number_of_threads = 0 uses all hardware threads
+	uint32_t ParallelRun(const DFATransitionTable& table, uint32_t state, const char* begin, const char* end, unsigned number_of_threads = 0);
+
+	// Returns true if the word in [data, data + size) is in the language of dfa. Uses ParallelRun
+	bool RecognizeParallel(const DFA& dfa, const char* data, size_t size, unsigned number_of_threads = 0);
+}
+
+#endif // SLARX_PARALLEL_RECOGNITION_H_INCLUDED
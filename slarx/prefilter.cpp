@@ -0,0 +1,58 @@
+#include "prefilter.h"
+
+#include <bitset>
+#include <cstring>
+#include <cstddef>
+
+namespace slarx
+{
+	Prefilter::Prefilter(const DFA& dfa) : number_of_first_characters_(0), required_substring_(dfa.ComputeRequiredSubstring())
+	{
+		std::bitset<256> first_characters = dfa.ComputeFirstCharacters();
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			is_first_character_[ c ] = first_characters[ c ];
+			if(first_characters[ c ])
+			{
+				if(number_of_first_characters_ < kMaxSearchedCharacters)
+				{
+					first_characters_[ number_of_first_characters_ ] = static_cast<char>(c);
+				}
+				++number_of_first_characters_;
+			}
+		}
+		// An empty word matches anywhere
+		if(dfa.GetAcceptingLookup()[ dfa.GetStartState().GetValue() ])
+		{
+			is_first_character_.fill(1);
+			number_of_first_characters_ = 256;
+		}
+	}
+
+	const char* Prefilter::FindCandidate(const char* begin, const char* end) const
+	{
+		if(number_of_first_characters_ == 0)
+			return end;
+		if(number_of_first_characters_ <= kMaxSearchedCharacters)
+			return FindAnyOf(begin, end, first_characters_.data(), number_of_first_characters_);
+		return FindAnyOf(begin, end, is_first_character_);
+	}
+
+	const char* Prefilter::FindRequiredSubstring(const char* begin, const char* end) const
+	{
+		const size_t length = required_substring_.size();
+		if(length == 0)
+			return begin;
+
+		// memchr finds the candidates for the first character, which are then compared in full
+		for(const char* position = begin; end - position >= static_cast<ptrdiff_t>(length); ++position)
+		{
+			position = static_cast<const char*>(std::memchr(position, required_substring_[ 0 ], end - position - length + 1));
+			if(position == nullptr)
+				break;
+			if(std::memcmp(position + 1, required_substring_.data() + 1, length - 1) == 0)
+				return position;
+		}
+		return end;
+	}
+}
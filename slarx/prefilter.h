@@ -0,0 +1,40 @@
+#pragma once
+#ifndef SLARX_PREFILTER_H_INCLUDED
+#define SLARX_PREFILTER_H_INCLUDED
+
+#include "dfa.h"
+#include <array>
+#include <string>
+#include <cstdint>
+
+namespace slarx
+{
+	// Quickly rules out parts of a text, which cannot contain a word of a DFA's language, so that searching runs the DFA
+	// only at the remaining positions. A nonempty word must start with one of the DFA's first characters, which are
+	// looked for with FindAnyOf when there are few of them, and every word must contain the DFA's
+	// required substring, whose first character is looked for with memchr
+	class Prefilter
+	{
+	public:
+		explicit Prefilter(const DFA& dfa);
+
+		// Returns the first position in [begin, end), at which a nonempty word of the language may start, or end if there is none
+		const char* FindCandidate(const char* begin, const char* end) const;
+		// Returns the first occurrence of the required substring in [begin, end), or end if there is none. Returns begin if
+		// there is no required substring
+		const char* FindRequiredSubstring(const char* begin, const char* end) const;
+
+		// Returns true if FindCandidate may skip characters
+		bool SkipsCharacters() const { return number_of_first_characters_ < 256; }
+		const std::string& GetRequiredSubstring() const { return required_substring_; }
+
+	private:
+		std::array<uint8_t, 256> is_first_character_;
+		unsigned number_of_first_characters_;
+		// The first characters, if there are at most kMaxSearchedCharacters of them
+		std::array<char, kMaxSearchedCharacters> first_characters_;
+		std::string required_substring_;
+	};
+}
+
+#endif // SLARX_PREFILTER_H_INCLUDED
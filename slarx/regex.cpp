@@ -0,0 +1,457 @@
+#include "regex.h"
+#include "regex_derivatives.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace slarx
+{
+	namespace
+	{
+		const unsigned char kFirstPrintableCharacter = ' ';
+		const unsigned char kLastPrintableCharacter = '~';
+
+		// The characters matched by '.' and negated classes
+		std::bitset<256> PrintableCharacters()
+		{
+			std::bitset<256> characters;
+			for(unsigned c = kFirstPrintableCharacter; c <= kLastPrintableCharacter; ++c)
+			{
+				characters.set(c);
+			}
+			characters.reset(static_cast<unsigned char>(kEpsilon));
+			return characters;
+		}
+
+		std::bitset<256> CharacterRange(unsigned char first, unsigned char last)
+		{
+			std::bitset<256> characters;
+			for(unsigned c = first; c <= last; ++c)
+			{
+				characters.set(c);
+			}
+			return characters;
+		}
+
+		// Recursive descent parser. Every Parse function parses one level of precedence (alternation, intersection, concatenation,
+		// complement, repetition, atom)
+		// starting at position_ and returns the index of the node it added
+		class RegexParser
+		{
+		public:
+			// Groups, complements and repetitions, which are nested deeper, are rejected. They nest the recursion of the parser and
+			// of the passes over the syntax tree, which would overflow the stack otherwise
+			static const unsigned kMaxNestingDepth = 1000;
+
+			explicit RegexParser(const std::string& pattern) : pattern_(pattern), position_(0), depth_(0) { }
+
+			RegexSyntaxTree Parse()
+			{
+				tree_.root = ParseAlternation();
+				if(position_ != pattern_.size())
+					Error("unmatched ')'");
+				return std::move(tree_);
+			}
+
+		private:
+			[[noreturn]] void Error(const std::string& message) const
+			{
+				throw std::invalid_argument("Invalid regular expression at position " + std::to_string(position_) + ": " + message + ".");
+			}
+
+			// Called when a group, a complement or a repetition is entered, which must be left with --depth_
+			void Nest()
+			{
+				if(++depth_ > kMaxNestingDepth)
+					Error("nested deeper than " + std::to_string(kMaxNestingDepth) + " levels");
+			}
+
+			bool AtEnd() const { return position_ == pattern_.size(); }
+			char Peek() const { return pattern_[ position_ ]; }
+
+			uint32_t AddNode(RegexNode::Type type, std::vector<uint32_t>&& children = std::vector<uint32_t>(), const std::bitset<256>& characters = std::bitset<256>())
+			{
+				tree_.nodes.push_back(RegexNode{ type, characters, std::move(children) });
+				return static_cast<uint32_t>(tree_.nodes.size() - 1);
+			}
+
+			uint32_t ParseAlternation()
+			{
+				std::vector<uint32_t> alternatives(1, ParseIntersection());
+				while(!AtEnd() && Peek() == '|')
+				{
+					++position_;
+					alternatives.push_back(ParseIntersection());
+				}
+				return alternatives.size() == 1 ? alternatives[ 0 ] : AddNode(RegexNode::Type::kAlternation, std::move(alternatives));
+			}
+
+			uint32_t ParseIntersection()
+			{
+				std::vector<uint32_t> operands(1, ParseConcatenation());
+				while(!AtEnd() && Peek() == '&')
+				{
+					++position_;
+					operands.push_back(ParseConcatenation());
+				}
+				return operands.size() == 1 ? operands[ 0 ] : AddNode(RegexNode::Type::kIntersection, std::move(operands));
+			}
+
+			uint32_t ParseConcatenation()
+			{
+				std::vector<uint32_t> factors;
+				while(!AtEnd() && Peek() != '|' && Peek() != '&' && Peek() != ')')
+				{
+					factors.push_back(ParseComplement());
+				}
+				if(factors.empty())
+					return AddNode(RegexNode::Type::kEmptyWord);
+				return factors.size() == 1 ? factors[ 0 ] : AddNode(RegexNode::Type::kConcatenation, std::move(factors));
+			}
+
+			uint32_t ParseComplement()
+			{
+				if(Peek() != '!')
+					return ParseRepetition();
+				Nest();
+				++position_;
+				if(AtEnd() || Peek() == '|' || Peek() == '&' || Peek() == ')')
+					Error("nothing to complement");
+				const uint32_t node = AddNode(RegexNode::Type::kComplement, std::vector<uint32_t>(1, ParseComplement()));
+				--depth_;
+				return node;
+			}
+
+			uint32_t ParseRepetition()
+			{
+				uint32_t node = ParseAtom();
+				const unsigned depth = depth_;
+				for(; !AtEnd(); ++position_)
+				{
+					if(Peek() == '*' || Peek() == '+' || Peek() == '?')
+						Nest();
+					if(Peek() == '*')
+						node = AddNode(RegexNode::Type::kStar, std::vector<uint32_t>(1, node));
+					else if(Peek() == '+')
+						node = AddNode(RegexNode::Type::kPlus, std::vector<uint32_t>(1, node));
+					else if(Peek() == '?')
+						node = AddNode(RegexNode::Type::kOptional, std::vector<uint32_t>(1, node));
+					else
+						break;
+				}
+				depth_ = depth;
+				return node;
+			}
+
+			uint32_t ParseAtom()
+			{
+				const char c = Peek();
+				switch(c)
+				{
+					case '(':
+					{
+						Nest();
+						++position_;
+						uint32_t node = ParseAlternation();
+						if(AtEnd())
+							Error("missing ')'");
+						++position_;
+						--depth_;
+						return node;
+					}
+					case '*':
+					case '+':
+					case '?':
+						Error(std::string("nothing to repeat with '") + c + "'");
+					case '[':
+						++position_;
+						return AddNode(RegexNode::Type::kCharacters, std::vector<uint32_t>(), ParseClass());
+					case '.':
+						++position_;
+						return AddNode(RegexNode::Type::kCharacters, std::vector<uint32_t>(), PrintableCharacters());
+					case '\\':
+						++position_;
+						return AddNode(RegexNode::Type::kCharacters, std::vector<uint32_t>(), ParseEscape());
+					default:
+						return AddNode(RegexNode::Type::kCharacters, std::vector<uint32_t>(), ParseCharacter());
+				}
+			}
+
+			// Parses a single (unescaped) character
+			std::bitset<256> ParseCharacter()
+			{
+				if(Peek() == kEpsilon)
+					Error(std::string("'") + kEpsilon + "' is reserved for epsilon transitions");
+				std::bitset<256> characters;
+				characters.set(static_cast<unsigned char>(pattern_[ position_++ ]));
+				return characters;
+			}
+
+			// Parses the character after a '\'
+			std::bitset<256> ParseEscape()
+			{
+				if(AtEnd())
+					Error("'\\' at the end of the expression");
+				std::bitset<256> characters;
+				switch(Peek())
+				{
+					case 'd':
+						characters = CharacterRange('0', '9');
+						break;
+					case 'w':
+						characters = CharacterRange('a', 'z') | CharacterRange('A', 'Z') | CharacterRange('0', '9');
+						characters.set('_');
+						break;
+					case 's':
+						for(char space : std::string(" \t\n\r\f\v"))
+						{
+							characters.set(static_cast<unsigned char>(space));
+						}
+						break;
+					case 'n':
+						characters.set('\n');
+						break;
+					case 't':
+						characters.set('\t');
+						break;
+					case 'r':
+						characters.set('\r');
+						break;
+					default:
+						return ParseCharacter();
+				}
+				++position_;
+				return characters;
+			}
+
+			// Parses a class after its '['. A ']' right after the '[' (or "[^") is a member of the class
+			std::bitset<256> ParseClass()
+			{
+				bool negated = false;
+				if(!AtEnd() && Peek() == '^')
+				{
+					negated = true;
+					++position_;
+				}
+				std::bitset<256> characters;
+				for(bool first = true; ; first = false)
+				{
+					if(AtEnd())
+						Error("missing ']'");
+					if(Peek() == ']' && !first)
+						break;
+
+					if(Peek() == '\\')
+					{
+						++position_;
+						characters |= ParseEscape();
+						continue;
+					}
+					const unsigned char from = static_cast<unsigned char>(Peek());
+					ParseCharacter();
+					if(position_ + 1 < pattern_.size() && Peek() == '-' && pattern_[ position_ + 1 ] != ']')
+					{
+						++position_;
+						const unsigned char to = static_cast<unsigned char>(Peek());
+						ParseCharacter();
+						if(to < from)
+							Error("invalid range");
+						characters |= CharacterRange(from, to);
+					}
+					else
+					{
+						characters.set(from);
+					}
+				}
+				++position_;
+
+				if(negated)
+				{
+					characters = PrintableCharacters() & ~characters;
+				}
+				characters.reset(static_cast<unsigned char>(kEpsilon));
+				return characters;
+			}
+
+			const std::string& pattern_;
+			size_t position_;
+			// The number of groups, complements and repetitions around position_
+			unsigned depth_;
+			RegexSyntaxTree tree_;
+		};
+
+		// Position sets of a subexpression. A position is the index of a kCharacters node in order of appearance, starting from 1
+		struct PositionSets
+		{
+			// True if the subexpression matches the empty word
+			bool nullable;
+			// The positions, which may be the first and the last in a word of the subexpression
+			std::vector<uint32_t> first;
+			std::vector<uint32_t> last;
+		};
+
+		class GlushkovBuilder
+		{
+		public:
+			explicit GlushkovBuilder(const RegexSyntaxTree& tree) : tree_(tree), characters_(1), follow_(1) { }
+
+			ConversionNFA Build()
+			{
+				PositionSets root = Visit(tree_.root);
+				// State 0 is the start state, which the first positions follow
+				follow_[ 0 ] = root.first;
+
+				Alphabet alphabet;
+				for(uint32_t p = 1; p < characters_.size(); ++p)
+				{
+					for(unsigned c = 0; c < 256; ++c)
+					{
+						if(characters_[ p ]->test(c))
+						{
+							alphabet.AddCharacter(static_cast<char>(c));
+						}
+					}
+				}
+
+				const uint32_t number_of_states = static_cast<uint32_t>(characters_.size());
+				ConversionNFATransitionTable transition_table(number_of_states, alphabet);
+				for(uint32_t q = 0; q < number_of_states; ++q)
+				{
+					std::sort(follow_[ q ].begin(), follow_[ q ].end());
+					follow_[ q ].erase(std::unique(follow_[ q ].begin(), follow_[ q ].end()), follow_[ q ].end());
+					for(uint32_t p : follow_[ q ])
+					{
+						for(char c : alphabet.GetCharacters())
+						{
+							if(characters_[ p ]->test(static_cast<unsigned char>(c)))
+							{
+								transition_table.AddTransition(State(q), c, State(p));
+							}
+						}
+					}
+				}
+
+				std::set<State> accepting_states;
+				for(uint32_t p : root.last)
+				{
+					accepting_states.insert(State(p));
+				}
+				if(root.nullable)
+				{
+					accepting_states.insert(State(0));
+				}
+				return ConversionNFA(number_of_states, alphabet, State(0), accepting_states, transition_table);
+			}
+
+		private:
+			PositionSets Visit(uint32_t index)
+			{
+				const RegexNode& node = tree_.nodes[ index ];
+				switch(node.type)
+				{
+					case RegexNode::Type::kEmptyWord:
+						return PositionSets{ true, std::vector<uint32_t>(), std::vector<uint32_t>() };
+					case RegexNode::Type::kCharacters:
+					{
+						const uint32_t position = static_cast<uint32_t>(characters_.size());
+						characters_.push_back(&node.characters);
+						follow_.emplace_back();
+						return PositionSets{ false, std::vector<uint32_t>(1, position), std::vector<uint32_t>(1, position) };
+					}
+					case RegexNode::Type::kConcatenation:
+					{
+						// last holds the positions, which may end a word of the factors visited so far
+						PositionSets result{ true, std::vector<uint32_t>(), std::vector<uint32_t>() };
+						for(uint32_t child : node.children)
+						{
+							PositionSets factor = Visit(child);
+							for(uint32_t p : result.last)
+							{
+								follow_[ p ].insert(follow_[ p ].end(), factor.first.begin(), factor.first.end());
+							}
+							if(result.nullable)
+							{
+								result.first.insert(result.first.end(), factor.first.begin(), factor.first.end());
+							}
+							if(factor.nullable)
+							{
+								result.last.insert(result.last.end(), factor.last.begin(), factor.last.end());
+							}
+							else
+							{
+								result.last = std::move(factor.last);
+							}
+							result.nullable = result.nullable && factor.nullable;
+						}
+						return result;
+					}
+					case RegexNode::Type::kAlternation:
+					{
+						PositionSets result{ false, std::vector<uint32_t>(), std::vector<uint32_t>() };
+						for(uint32_t child : node.children)
+						{
+							PositionSets alternative = Visit(child);
+							result.nullable = result.nullable || alternative.nullable;
+							result.first.insert(result.first.end(), alternative.first.begin(), alternative.first.end());
+							result.last.insert(result.last.end(), alternative.last.begin(), alternative.last.end());
+						}
+						return result;
+					}
+					case RegexNode::Type::kIntersection:
+					case RegexNode::Type::kComplement:
+						throw std::invalid_argument("Intersection and complement are supported only by the derivatives regular expression engine.");
+					default:
+					{
+						PositionSets result = Visit(node.children[ 0 ]);
+						if(node.type != RegexNode::Type::kOptional)
+						{
+							for(uint32_t p : result.last)
+							{
+								follow_[ p ].insert(follow_[ p ].end(), result.first.begin(), result.first.end());
+							}
+						}
+						if(node.type != RegexNode::Type::kPlus)
+						{
+							result.nullable = true;
+						}
+						return result;
+					}
+				}
+			}
+
+			const RegexSyntaxTree& tree_;
+			// The characters of every position. Entry 0 belongs to the start state and is unused
+			std::vector<const std::bitset<256>*> characters_;
+			// follow_[ p ] are the positions, which may come right after position p (or first, for the start state 0)
+			std::vector<std::vector<uint32_t> > follow_;
+		};
+	}
+
+	RegexSyntaxTree ParseRegex(const std::string& pattern)
+	{
+		return RegexParser(pattern).Parse();
+	}
+
+	ConversionNFA RegexToNFA(const std::string& pattern)
+	{
+		RegexSyntaxTree tree = ParseRegex(pattern);
+		return GlushkovBuilder(tree).Build();
+	}
+
+	DFA CompileRegex(const std::string& pattern, RegexEngine engine, bool report_automaton_was_created)
+	{
+		if(engine == RegexEngine::kDerivatives)
+			return CompileRegexWithDerivatives(pattern, report_automaton_was_created);
+		return RegexToNFA(pattern).ToDFA(report_automaton_was_created);
+	}
+
+	RegexEngine ParseRegexEngine(const std::string& name)
+	{
+		if(name == "glushkov")
+			return RegexEngine::kGlushkov;
+		else if(name == "derivatives")
+			return RegexEngine::kDerivatives;
+		else
+			throw(std::invalid_argument("Unknown regular expression engine " + name + " (should be glushkov or derivatives)"));
+	}
+}
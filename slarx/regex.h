@@ -0,0 +1,76 @@
+#pragma once
+#ifndef SLARX_REGEX_H_INCLUDED
+#define SLARX_REGEX_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "dfa.h"
+#include <bitset>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace slarx
+{
+	// A node of the syntax tree of a regular expression
+	struct RegexNode
+	{
+		enum class Type
+		{
+			// Matches only the empty word, e.g. "()" or an empty alternative
+			kEmptyWord,
+			// Matches a single character of characters (a literal, a class or '.')
+			kCharacters,
+			kConcatenation,
+			kAlternation,
+			kStar,
+			kPlus,
+			kOptional,
+			// Supported only by RegexEngine::kDerivatives
+			kIntersection,
+			kComplement
+		};
+
+		Type type;
+		std::bitset<256> characters;
+		// Indices into RegexSyntaxTree::nodes. Concatenations, alternations and intersections have two or more children, the others one
+		std::vector<uint32_t> children;
+	};
+
+	struct RegexSyntaxTree
+	{
+		std::vector<RegexNode> nodes;
+		uint32_t root;
+	};
+
+	// Parses a regular expression. The syntax is:
+	//  a|b    alternation            ab     concatenation            ( )   grouping
+	//  a*     zero or more           a+     one or more              a?    zero or one
+	//  [abc]  one of the characters  [a-z]  a range of characters    [^a]  any character except the listed ones
+	//  .      any character          \x     the character x, for the metacharacters \ ( ) [ ] | * + ? . & !
+	//  \d \w \s digits, word characters and whitespace. \n \t \r newline, tab and carriage return
+	//  a&b    intersection, binds tighter than alternation and looser than concatenation
+	//  !a     complement (relative to all words over the characters of the expression), binds looser than repetitions
+	// '.' and negated classes match the printable ASCII characters. kEpsilon may not be used, because it marks epsilon transitions.
+	// Throws std::invalid_argument, which names the position of the error, if the expression is malformed or nests groups,
+	// complements and repetitions more than 1000 levels deep
+	RegexSyntaxTree ParseRegex(const std::string& pattern);
+
+	enum class RegexEngine
+	{
+		// Determinizes the Glushkov automaton of the expression. Does not support intersection and complement
+		kGlushkov,
+		// Builds the DFA directly from the derivatives of the expression (see regex_derivatives.h)
+		kDerivatives
+	};
+
+	// Builds the Glushkov automaton of a regular expression, which has a state for every character position of the expression and
+	// a start state, and no epsilon transitions. A transition leads to a position on its characters from the positions, which the
+	// position may follow in a word
+	ConversionNFA RegexToNFA(const std::string& pattern);
+	// Compiles a regular expression into a DFA with the chosen engine
+	DFA CompileRegex(const std::string& pattern, RegexEngine engine = RegexEngine::kGlushkov, bool report_automaton_was_created = true);
+	// Returns the engine named "glushkov" or "derivatives". Throws std::invalid_argument for other names
+	RegexEngine ParseRegexEngine(const std::string& name);
+}
+
+#endif // SLARX_REGEX_H_INCLUDED
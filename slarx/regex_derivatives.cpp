@@ -0,0 +1,358 @@
+#include "regex_derivatives.h"
+#include "utility.h"
+
+#include <algorithm>
+#include <bitset>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace slarx
+{
+	namespace
+	{
+		enum class ExpressionKind : uint32_t
+		{
+			// Matches no word
+			kEmptySet,
+			kEmptyWord,
+			kCharacters,
+			// Binary, so that a concatenation of several factors is nested to the right
+			kConcatenation,
+			kStar,
+			kAlternation,
+			kIntersection,
+			kComplement
+		};
+
+		struct Expression
+		{
+			ExpressionKind kind;
+			// True if the expression matches the empty word
+			bool nullable;
+			// Index into ExpressionPool's character sets, for kCharacters
+			uint32_t characters;
+			// Sorted for alternations and intersections
+			std::vector<uint32_t> children;
+		};
+
+		// Hash conses expressions, so that an expression is identified by its ID. The constructors return the ID of
+		// the normal form of the expression they build, so that derivatives of an expression repeat after finitely many steps
+		class ExpressionPool
+		{
+		public:
+			ExpressionPool()
+			{
+				empty_set_ = Intern(ExpressionKind::kEmptySet, false, 0, std::vector<uint32_t>());
+				empty_word_ = Intern(ExpressionKind::kEmptyWord, true, 0, std::vector<uint32_t>());
+				universe_ = Intern(ExpressionKind::kComplement, true, 0, std::vector<uint32_t>(1, empty_set_));
+			}
+
+			const Expression& Get(uint32_t id) const { return expressions_[ id ]; }
+			const std::bitset<256>& GetCharacters(uint32_t id) const { return character_sets_[ expressions_[ id ].characters ]; }
+
+			uint32_t EmptySet() const { return empty_set_; }
+			uint32_t EmptyWord() const { return empty_word_; }
+
+			uint32_t Characters(const std::bitset<256>& characters)
+			{
+				if(characters.none())
+					return empty_set_;
+				auto inserted = character_set_index_.insert(std::make_pair(characters, static_cast<uint32_t>(character_sets_.size())));
+				if(inserted.second)
+				{
+					character_sets_.push_back(characters);
+				}
+				return Intern(ExpressionKind::kCharacters, false, inserted.first->second, std::vector<uint32_t>());
+			}
+
+			uint32_t Concatenation(uint32_t a, uint32_t b)
+			{
+				if(a == empty_set_ || b == empty_set_)
+					return empty_set_;
+				if(a == empty_word_)
+					return b;
+				if(b == empty_word_)
+					return a;
+				// (xy)b = x(yb)
+				if(Get(a).kind == ExpressionKind::kConcatenation)
+				{
+					const uint32_t x = Get(a).children[ 0 ], y = Get(a).children[ 1 ];
+					return Concatenation(x, Concatenation(y, b));
+				}
+				const bool nullable = Get(a).nullable && Get(b).nullable;
+				return Intern(ExpressionKind::kConcatenation, nullable, 0, std::vector<uint32_t>{ a, b });
+			}
+
+			uint32_t Star(uint32_t a)
+			{
+				if(a == empty_set_ || a == empty_word_)
+					return empty_word_;
+				if(Get(a).kind == ExpressionKind::kStar)
+					return a;
+				return Intern(ExpressionKind::kStar, true, 0, std::vector<uint32_t>(1, a));
+			}
+
+			// The alternatives are flattened, the character sets among them are merged into one and the empty set is dropped
+			uint32_t Alternation(const std::vector<uint32_t>& alternatives)
+			{
+				std::vector<uint32_t> children;
+				std::bitset<256> characters;
+				bool nullable = false;
+				for(uint32_t alternative : alternatives)
+				{
+					const std::vector<uint32_t> operands = Get(alternative).kind == ExpressionKind::kAlternation ?
+						Get(alternative).children : std::vector<uint32_t>(1, alternative);
+					for(uint32_t operand : operands)
+					{
+						if(operand == universe_)
+							return universe_;
+						if(Get(operand).kind == ExpressionKind::kCharacters)
+						{
+							characters |= GetCharacters(operand);
+						}
+						else if(operand != empty_set_)
+						{
+							children.push_back(operand);
+							nullable = nullable || Get(operand).nullable;
+						}
+					}
+				}
+				if(characters.any())
+				{
+					children.push_back(Characters(characters));
+				}
+				return Normalize(ExpressionKind::kAlternation, nullable, std::move(children), empty_set_);
+			}
+
+			// The operands are flattened and the universe is dropped
+			uint32_t Intersection(const std::vector<uint32_t>& operands)
+			{
+				std::vector<uint32_t> children;
+				bool nullable = true;
+				for(uint32_t operand : operands)
+				{
+					const std::vector<uint32_t> flattened = Get(operand).kind == ExpressionKind::kIntersection ?
+						Get(operand).children : std::vector<uint32_t>(1, operand);
+					for(uint32_t child : flattened)
+					{
+						if(child == empty_set_)
+							return empty_set_;
+						if(child != universe_)
+						{
+							children.push_back(child);
+							nullable = nullable && Get(child).nullable;
+						}
+					}
+				}
+				return Normalize(ExpressionKind::kIntersection, nullable, std::move(children), universe_);
+			}
+
+			uint32_t Complement(uint32_t a)
+			{
+				if(Get(a).kind == ExpressionKind::kComplement)
+					return Get(a).children[ 0 ];
+				return Intern(ExpressionKind::kComplement, !Get(a).nullable, 0, std::vector<uint32_t>(1, a));
+			}
+
+			// Returns the derivative of an expression by c, which is memoized, because the derivatives of the DFA states
+			// share most of their subexpressions
+			uint32_t Derivative(uint32_t id, char c)
+			{
+				const uint64_t key = (static_cast<uint64_t>(id) << 8) | static_cast<unsigned char>(c);
+				auto found = derivatives_.find(key);
+				if(found != derivatives_.end())
+					return found->second;
+
+				// Copied, because the constructors may reallocate expressions_
+				const Expression expression = Get(id);
+				uint32_t derivative = empty_set_;
+				switch(expression.kind)
+				{
+					case ExpressionKind::kEmptySet:
+					case ExpressionKind::kEmptyWord:
+						break;
+					case ExpressionKind::kCharacters:
+						derivative = character_sets_[ expression.characters ].test(static_cast<unsigned char>(c)) ? empty_word_ : empty_set_;
+						break;
+					case ExpressionKind::kConcatenation:
+					{
+						// d(ab) = d(a)b | d(b) if a is nullable
+						const uint32_t a = expression.children[ 0 ], b = expression.children[ 1 ];
+						derivative = Concatenation(Derivative(a, c), b);
+						if(Get(a).nullable)
+						{
+							derivative = Alternation(std::vector<uint32_t>{ derivative, Derivative(b, c) });
+						}
+						break;
+					}
+					case ExpressionKind::kStar:
+						derivative = Concatenation(Derivative(expression.children[ 0 ], c), id);
+						break;
+					case ExpressionKind::kAlternation:
+					case ExpressionKind::kIntersection:
+					{
+						std::vector<uint32_t> operands;
+						for(uint32_t child : expression.children)
+						{
+							operands.push_back(Derivative(child, c));
+						}
+						derivative = expression.kind == ExpressionKind::kAlternation ? Alternation(operands) : Intersection(operands);
+						break;
+					}
+					case ExpressionKind::kComplement:
+						derivative = Complement(Derivative(expression.children[ 0 ], c));
+						break;
+				}
+				derivatives_.insert(std::make_pair(key, derivative));
+				return derivative;
+			}
+
+		private:
+			// Sorts and deduplicates the operands of an alternation or an intersection, which is identity if there are none
+			uint32_t Normalize(ExpressionKind kind, bool nullable, std::vector<uint32_t>&& children, uint32_t identity)
+			{
+				std::sort(children.begin(), children.end());
+				children.erase(std::unique(children.begin(), children.end()), children.end());
+				if(children.empty())
+					return identity;
+				if(children.size() == 1)
+					return children[ 0 ];
+				return Intern(kind, nullable, 0, std::move(children));
+			}
+
+			uint32_t Intern(ExpressionKind kind, bool nullable, uint32_t characters, std::vector<uint32_t>&& children)
+			{
+				std::vector<uint32_t> key;
+				key.reserve(children.size() + 2);
+				key.push_back(static_cast<uint32_t>(kind));
+				key.push_back(characters);
+				key.insert(key.end(), children.begin(), children.end());
+				auto inserted = expression_index_.insert(std::make_pair(std::move(key), static_cast<uint32_t>(expressions_.size())));
+				if(inserted.second)
+				{
+					expressions_.push_back(Expression{ kind, nullable, characters, std::move(children) });
+				}
+				return inserted.first->second;
+			}
+
+			std::vector<Expression> expressions_;
+			// Keyed by the kind, the character set and the children of an expression
+			std::unordered_map<std::vector<uint32_t>, uint32_t, ContainerHash> expression_index_;
+			std::vector<std::bitset<256> > character_sets_;
+			std::unordered_map<std::bitset<256>, uint32_t> character_set_index_;
+			// Keyed by (expression ID << 8) | character
+			std::unordered_map<uint64_t, uint32_t> derivatives_;
+			uint32_t empty_set_;
+			uint32_t empty_word_;
+			// The complement of the empty set, which matches every word
+			uint32_t universe_;
+		};
+
+		// Adds the expression of a syntax tree node to the pool and collects the characters of the expression
+		uint32_t AddToPool(const RegexSyntaxTree& tree, uint32_t index, ExpressionPool& pool, std::bitset<256>& characters)
+		{
+			const RegexNode& node = tree.nodes[ index ];
+			std::vector<uint32_t> children;
+			for(uint32_t child : node.children)
+			{
+				children.push_back(AddToPool(tree, child, pool, characters));
+			}
+			switch(node.type)
+			{
+				case RegexNode::Type::kEmptyWord:
+					return pool.EmptyWord();
+				case RegexNode::Type::kCharacters:
+					characters |= node.characters;
+					return pool.Characters(node.characters);
+				case RegexNode::Type::kConcatenation:
+				{
+					uint32_t result = children.back();
+					for(size_t i = children.size() - 1; i-- > 0; )
+					{
+						result = pool.Concatenation(children[ i ], result);
+					}
+					return result;
+				}
+				case RegexNode::Type::kAlternation:
+					return pool.Alternation(children);
+				case RegexNode::Type::kStar:
+					return pool.Star(children[ 0 ]);
+				case RegexNode::Type::kPlus:
+					return pool.Concatenation(children[ 0 ], pool.Star(children[ 0 ]));
+				case RegexNode::Type::kOptional:
+					return pool.Alternation(std::vector<uint32_t>{ children[ 0 ], pool.EmptyWord() });
+				case RegexNode::Type::kIntersection:
+					return pool.Intersection(children);
+				default:
+					return pool.Complement(children[ 0 ]);
+			}
+		}
+	}
+
+	DFA CompileRegexWithDerivatives(const std::string& pattern, bool report_automaton_was_created)
+	{
+		return CompileRegexWithDerivatives(ParseRegex(pattern), report_automaton_was_created);
+	}
+
+	DFA CompileRegexWithDerivatives(const RegexSyntaxTree& tree, bool report_automaton_was_created)
+	{
+		ExpressionPool pool;
+		std::bitset<256> characters;
+		const uint32_t root = AddToPool(tree, tree.root, pool, characters);
+
+		Alphabet alphabet;
+		for(unsigned c = 0; c < 256; ++c)
+		{
+			if(characters.test(c))
+			{
+				alphabet.AddCharacter(static_cast<char>(c));
+			}
+		}
+		// Two characters have the same derivative of every expression, if every character set of the expression contains
+		// both or neither of them, so one derivative per class suffices
+		ByteClasses classes(alphabet, false);
+		for(const RegexNode& node : tree.nodes)
+		{
+			if(node.type == RegexNode::Type::kCharacters)
+			{
+				classes.Refine([&node](unsigned char c) -> uint32_t { return node.characters.test(c); });
+			}
+		}
+		std::vector<char> class_representatives = classes.GetRepresentatives();
+
+		// DFA state i is the expression expressions[ i ]
+		std::vector<uint32_t> expressions;
+		std::unordered_map<uint32_t, uint32_t> state_of_expression;
+		std::set<State> accepting_states;
+		DFATransitionTable transition_table(0, alphabet, classes);
+		auto find_or_add_state = [&](uint32_t expression) -> State
+		{
+			auto inserted = state_of_expression.insert(std::make_pair(expression, static_cast<uint32_t>(expressions.size())));
+			if(inserted.second)
+			{
+				if(pool.Get(expression).nullable)
+				{
+					accepting_states.insert(State(inserted.first->second));
+				}
+				expressions.push_back(expression);
+				transition_table.SetNumberOfStates(expressions.size());
+			}
+			return State(inserted.first->second);
+		};
+
+		State start_state = find_or_add_state(root);
+		for(uint32_t i = 0; i < expressions.size(); ++i)
+		{
+			for(char c : class_representatives)
+			{
+				State to = find_or_add_state(pool.Derivative(expressions[ i ], c));
+				transition_table.AddTransition(State(i), c, to);
+			}
+		}
+
+		uint32_t number_of_states = expressions.size();
+		return DFA(std::move(number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states),
+				   std::move(transition_table), report_automaton_was_created);
+	}
+}
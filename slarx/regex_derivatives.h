@@ -0,0 +1,22 @@
+#pragma once
+#ifndef SLARX_REGEX_DERIVATIVES_H_INCLUDED
+#define SLARX_REGEX_DERIVATIVES_H_INCLUDED
+
+#include "dfa.h"
+#include "regex.h"
+#include <string>
+
+namespace slarx
+{
+	// Compiles a regular expression straight into a DFA with Brzozowski derivatives. The derivative of an expression by a
+	// character matches the rests of its words, which start with the character, so every DFA state is an expression and its
+	// transitions lead to its derivatives. Expressions are hash consed and built by constructors, which bring them to a normal
+	// form (alternations and intersections are flattened, sorted and deduplicated, and trivial operands are simplified away),
+	// so equal expressions get the same ID and the construction ends with a finite number of states. Unlike the Glushkov
+	// construction, this supports intersection and complement, where the complement is taken relative to all words over the
+	// characters of the expression. Throws std::invalid_argument if the expression is malformed
+	DFA CompileRegexWithDerivatives(const std::string& pattern, bool report_automaton_was_created = true);
+	DFA CompileRegexWithDerivatives(const RegexSyntaxTree& tree, bool report_automaton_was_created = true);
+}
+
+#endif // SLARX_REGEX_DERIVATIVES_H_INCLUDED
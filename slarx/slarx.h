@@ -8,6 +8,21 @@
 #include "dfa.h"
 #include "graph.h"
 #include "automata_set_operations.h"
+#include "dfa_minimization.h"
+#include "lazy_dfa.h"
+#include "bit_parallel_nfa.h"
+#include "nfa_recognizer.h"
+#include "parallel_recognition.h"
+#include "interleaved_run.h"
+#include "prefilter.h"
+#include "dfa_search.h"
+#include "multi_pattern.h"
+#include "dfa_stream_matcher.h"
+#include "regex.h"
+#include "regex_derivatives.h"
+#include "dictionary_dfa.h"
+#include "aho_corasick.h"
+#include "suffix_automaton.h"
 #include "command_line.h"
 
 #endif // SLARX_H_INCLUDED
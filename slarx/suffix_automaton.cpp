@@ -0,0 +1,181 @@
+#include "suffix_automaton.h"
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+namespace slarx
+{
+	const uint32_t SuffixAutomaton::kNoState;
+	const size_t SuffixAutomaton::kNotFound;
+
+	SuffixAutomaton::SuffixAutomaton(const char* data, size_t size, bool report_automaton_was_created)
+		: dfa_(Build(data, size, report_automaton_was_created))
+	{
+	}
+
+	DFA SuffixAutomaton::Build(const char* data, size_t size, bool report_automaton_was_created)
+	{
+		// A text of length n has at most 2n - 1 states, which must stay below kNoState and the sink row
+		if(size > (kNoState - 2) / 2)
+			throw std::invalid_argument("The text is too long for a suffix automaton.");
+		Alphabet alphabet;
+		for(size_t i = 0; i < size; ++i)
+		{
+			if(data[ i ] == kEpsilon)
+				throw std::invalid_argument(std::string("The text of a suffix automaton may not contain '") + kEpsilon + "'.");
+			if(!alphabet.Contains(data[ i ]))
+			{
+				alphabet.AddCharacter(data[ i ]);
+			}
+		}
+		const ByteClasses classes(alphabet, true);
+		const uint32_t number_of_columns = classes.Size();
+
+		// The transitions are added directly to the table of the DFA, which has rows for the at most 2n - 1 states, the dead state
+		// and the sink row up front, so that it is never copied while the automaton grows. It is cut down to the actual states
+		// once they are known
+		const size_t maximal_number_of_states = std::max<size_t>(2 * size, 2);
+		DFATransitionTable transition_table(static_cast<unsigned>(maximal_number_of_states + 1), alphabet, classes);
+		lengths_.reserve(maximal_number_of_states);
+		suffix_links_.reserve(maximal_number_of_states);
+		occurrences_.reserve(maximal_number_of_states);
+		first_ends_.reserve(maximal_number_of_states);
+		auto add_state = [&](uint32_t length, uint32_t suffix_link, uint32_t occurrences, uint32_t first_end) -> uint32_t
+		{
+			lengths_.push_back(length);
+			suffix_links_.push_back(suffix_link);
+			occurrences_.push_back(occurrences);
+			first_ends_.push_back(first_end);
+			return static_cast<uint32_t>(lengths_.size() - 1);
+		};
+		auto transition = [&](uint32_t state, ByteClasses::Class on) -> uint32_t { return transition_table.GetClassTransition(state, on); };
+
+		add_state(0, kNoState, 0, 0);
+		// The state of the whole text read so far
+		uint32_t last = 0;
+		for(size_t i = 0; i < size; ++i)
+		{
+			const ByteClasses::Class c = classes.Get(data[ i ]);
+			// A new state ends only at the new position, so it counts one occurrence of its own
+			const uint32_t current = add_state(lengths_[ last ] + 1, kNoState, 1, static_cast<uint32_t>(i + 1));
+			// The suffixes of the text, which can not be extended by c yet, are extended to the new state
+			uint32_t p = last;
+			for(; p != kNoState && transition(p, c) == DFATransitionTable::kNoTransition; p = suffix_links_[ p ])
+			{
+				transition_table.SetClassTransition(p, c, current);
+			}
+
+			if(p == kNoState)
+			{
+				suffix_links_[ current ] = 0;
+			}
+			else if(lengths_[ transition(p, c) ] == lengths_[ p ] + 1)
+			{
+				suffix_links_[ current ] = transition(p, c);
+			}
+			else
+			{
+				// The longest suffix, which is extended by c, shares a state with longer substrings, which do not end at
+				// the new position, so it is split off into a clone
+				const uint32_t q = transition(p, c);
+				const uint32_t clone = add_state(lengths_[ p ] + 1, suffix_links_[ q ], 0, first_ends_[ q ]);
+				for(ByteClasses::Class k = 1; k < number_of_columns; ++k)
+				{
+					transition_table.SetClassTransition(clone, k, transition(q, k));
+				}
+				for(; p != kNoState && transition(p, c) == q; p = suffix_links_[ p ])
+				{
+					transition_table.SetClassTransition(p, c, clone);
+				}
+				suffix_links_[ q ] = clone;
+				suffix_links_[ current ] = clone;
+			}
+			last = current;
+		}
+
+		// A state ends at the end positions of the states, whose suffix link leads to it, so the occurrences are summed up
+		// from the longest states down, which are sorted by length with a counting sort
+		const uint32_t number_of_states = static_cast<uint32_t>(lengths_.size());
+		std::vector<uint32_t> length_offsets(size + 2, 0);
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			++length_offsets[ lengths_[ s ] + 1 ];
+		}
+		for(size_t length = 0; length <= size; ++length)
+		{
+			length_offsets[ length + 1 ] += length_offsets[ length ];
+		}
+		std::vector<uint32_t> by_length(number_of_states);
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			by_length[ length_offsets[ lengths_[ s ] ]++ ] = s;
+		}
+		for(uint32_t i = number_of_states; i-- > 1; )
+		{
+			const uint32_t s = by_length[ i ];
+			occurrences_[ suffix_links_[ s ] ] += occurrences_[ s ];
+		}
+		// The empty word occurs before every character and at the end
+		occurrences_[ 0 ] = static_cast<uint32_t>(size + 1);
+
+		std::set<State> accepting_states;
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			accepting_states.insert(accepting_states.end(), State(s));
+		}
+		// A DFA must be complete over its alphabet (e.g. for Complement and Export), so the missing transitions lead to a rejecting
+		// dead state after the states of the automaton. Shrinking keeps the capacity, so the sink row is added without copying the table
+		const uint32_t dead_state = number_of_states;
+		for(uint32_t s = 0; s < number_of_states; ++s)
+		{
+			for(ByteClasses::Class k = 1; k < number_of_columns; ++k)
+			{
+				if(transition(s, k) == DFATransitionTable::kNoTransition)
+				{
+					transition_table.SetClassTransition(s, k, dead_state);
+				}
+			}
+		}
+		for(ByteClasses::Class k = 1; k < number_of_columns; ++k)
+		{
+			transition_table.SetClassTransition(dead_state, k, dead_state);
+		}
+		transition_table.SetNumberOfStates(number_of_states + 1);
+
+		uint32_t dfa_number_of_states = number_of_states + 1;
+		State start_state = State(0);
+		return DFA(std::move(dfa_number_of_states), std::move(alphabet), std::move(start_state), std::move(accepting_states),
+				   std::move(transition_table), report_automaton_was_created);
+	}
+
+	uint32_t SuffixAutomaton::FindState(std::string_view word) const
+	{
+		const uint32_t state = dfa_.Advance(dfa_.GetStartState().GetValue(), word.data(), word.size());
+		// The dead state and the sink row come after the states of the automaton
+		return state >= lengths_.size() ? kNoState : state;
+	}
+
+	uint64_t SuffixAutomaton::CountOccurrences(std::string_view word) const
+	{
+		const uint32_t state = FindState(word);
+		return state == kNoState ? 0 : occurrences_[ state ];
+	}
+
+	size_t SuffixAutomaton::FindFirstOccurrence(std::string_view word) const
+	{
+		const uint32_t state = FindState(word);
+		return state == kNoState ? kNotFound : first_ends_[ state ] - word.size();
+	}
+
+	uint64_t SuffixAutomaton::CountDistinctSubstrings() const
+	{
+		// A state holds the suffixes of its longest substring, which are longer than the longest substring of its suffix link
+		uint64_t count = 0;
+		for(uint32_t s = 1; s < lengths_.size(); ++s)
+		{
+			count += lengths_[ s ] - lengths_[ suffix_links_[ s ] ];
+		}
+		return count;
+	}
+}
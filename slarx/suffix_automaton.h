@@ -0,0 +1,66 @@
+#pragma once
+#ifndef SLARX_SUFFIX_AUTOMATON_H_INCLUDED
+#define SLARX_SUFFIX_AUTOMATON_H_INCLUDED
+
+#include "conversion_nfa.h"
+#include "dfa.h"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace slarx
+{
+	// The suffix automaton (DAWG) of a text, which is the minimal DFA of its suffixes. A state is a set of substrings, which end
+	// at the same positions of the text, and the suffix link of a state leads to the state of its longest suffix, which ends at
+	// more positions. The automaton is built online, one character at a time, with lists of edges, in time and space linear in
+	// the length n of the text for a fixed alphabet (Blumer et al.). With every state accepting, its DFA accepts the substrings of
+	// the text. The DFA has a dense table with a row for each of its up to 2n states and a column for each character of the text,
+	// so it takes O(n * alphabet size) space. The states of the DFA are numbered like the states of the automaton, so the state
+	// reached by a substring (e.g. with DFA::Advance) tells how often it occurs. They are followed by a rejecting dead state, to
+	// which the words over the alphabet, that are not substrings, lead
+	class SuffixAutomaton
+	{
+	public:
+		static const uint32_t kNoState = UINT32_MAX;
+		static const size_t kNotFound = SIZE_MAX;
+
+		// Throws std::invalid_argument if the text contains kEpsilon or is too long for 32-bit states
+		SuffixAutomaton(const char* data, size_t size, bool report_automaton_was_created = false);
+
+		// Returns the DFA, whose language is the set of substrings of the text (including the empty word)
+		const DFA& GetDFA() const { return dfa_; }
+		// Moves the DFA out of the automaton, which can not be used afterwards
+		DFA ReleaseDFA() { return DFA(std::move(dfa_), false); }
+
+		// Returns the state reached by word, or kNoState if word is not a substring of the text
+		uint32_t FindState(std::string_view word) const;
+		bool Contains(std::string_view word) const { return FindState(word) != kNoState; }
+		// Returns the number of (possibly overlapping) occurrences of word in the text. The empty word occurs size + 1 times
+		uint64_t CountOccurrences(std::string_view word) const;
+		// Returns the position, at which the first occurrence of word in the text begins, or kNotFound
+		size_t FindFirstOccurrence(std::string_view word) const;
+		// Returns the number of distinct nonempty substrings of the text
+		uint64_t CountDistinctSubstrings() const;
+
+		// Returns the number of occurrences of the substrings of a state
+		uint64_t GetNumberOfOccurrences(uint32_t state) const { return occurrences_[ state ]; }
+		// Returns the position after the first occurrence of the substrings of a state (they all end there)
+		size_t GetFirstEnd(uint32_t state) const { return first_ends_[ state ]; }
+		// Returns the length of the longest substring of a state
+		uint32_t GetLength(uint32_t state) const { return lengths_[ state ]; }
+		uint32_t GetSuffixLink(uint32_t state) const { return suffix_links_[ state ]; }
+
+	private:
+		// Builds the automaton and returns its DFA. Called by the constructor before dfa_ is initialized
+		DFA Build(const char* data, size_t size, bool report_automaton_was_created);
+
+		std::vector<uint32_t> lengths_;
+		// kNoState for the start state
+		std::vector<uint32_t> suffix_links_;
+		std::vector<uint32_t> occurrences_;
+		std::vector<uint32_t> first_ends_;
+		DFA dfa_;
+	};
+}
+
+#endif // SLARX_SUFFIX_AUTOMATON_H_INCLUDED
@@ -8,6 +8,24 @@
 #include <cctype>
 #include <exception>
 #include <set>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SLARX_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace slarx
 {
@@ -47,8 +65,140 @@ namespace slarx
 		return tokens;
 	}
 
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0), file_handle_(INVALID_HANDLE_VALUE), mapping_handle_(nullptr)
+	{
+		file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER file_size;
+		if(file_handle_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle_, &file_size))
+		{
+			if(file_handle_ != INVALID_HANDLE_VALUE)
+				CloseHandle(file_handle_);
+			throw std::invalid_argument("Failed to open file " + path);
+		}
+		size_ = static_cast<size_t>(file_size.QuadPart);
+		if(size_ == 0)
+			return;
+
+		mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mapping_handle_ != nullptr)
+			data_ = static_cast<const char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+		if(data_ == nullptr)
+		{
+			if(mapping_handle_ != nullptr)
+				CloseHandle(mapping_handle_);
+			CloseHandle(file_handle_);
+			throw std::invalid_argument("Failed to map file " + path);
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if(data_ != nullptr)
+			UnmapViewOfFile(data_);
+		if(mapping_handle_ != nullptr)
+			CloseHandle(mapping_handle_);
+		if(file_handle_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_handle_);
+	}
+#else
+	MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0)
+	{
+		int file_descriptor = open(path.c_str(), O_RDONLY);
+		struct stat file_status;
+		if(file_descriptor < 0 || fstat(file_descriptor, &file_status) != 0)
+		{
+			if(file_descriptor >= 0)
+				close(file_descriptor);
+			throw std::invalid_argument("Failed to open file " + path);
+		}
+		size_ = static_cast<size_t>(file_status.st_size);
+		if(size_ != 0)
+		{
+			void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+			if(mapping == MAP_FAILED)
+			{
+				close(file_descriptor);
+				throw std::invalid_argument("Failed to map file " + path);
+			}
+			data_ = static_cast<const char*>(mapping);
+		}
+		// The mapping stays valid after the descriptor is closed
+		close(file_descriptor);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if(data_ != nullptr)
+			munmap(const_cast<char*>(data_), size_);
+	}
+#endif
+
+	std::vector<std::string_view> SplitLines(const char* data, size_t size)
+	{
+		std::vector<std::string_view> lines;
+		const char* position = data;
+		const char* end = data + size;
+		while(position != end)
+		{
+			const char* line_end = static_cast<const char*>(std::memchr(position, '\n', end - position));
+			const char* next = line_end != nullptr ? line_end + 1 : end;
+			if(line_end == nullptr)
+				line_end = end;
+			if(line_end != position && line_end[ -1 ] == '\r')
+				--line_end;
+			lines.emplace_back(position, line_end - position);
+			position = next;
+		}
+		return lines;
+	}
+
 	void Debug(const std::string& debug_message)
 	{
 		std::cerr << debug_message << std::endl;
 	}
-}
\ No newline at end of file
+
+	const char* FindAnyOf(const char* begin, const char* end, const char* characters, unsigned number_of_characters)
+	{
+		if(number_of_characters == 1)
+		{
+			const void* found = std::memchr(begin, characters[ 0 ], end - begin);
+			return found != nullptr ? static_cast<const char*>(found) : end;
+		}
+
+#ifdef SLARX_SSE2
+		// The third comparison repeats the second one for two characters
+		const __m128i first = _mm_set1_epi8(characters[ 0 ]);
+		const __m128i second = _mm_set1_epi8(characters[ 1 ]);
+		const __m128i third = _mm_set1_epi8(characters[ number_of_characters - 1 ]);
+		for(; end - begin >= 16; begin += 16)
+		{
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const __m128i equal = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)), _mm_cmpeq_epi8(block, third));
+			const int mask = _mm_movemask_epi8(equal);
+			if(mask != 0)
+				return begin + CountTrailingZeros(static_cast<uint64_t>(mask));
+		}
+#endif
+		for(; begin != end; ++begin)
+		{
+			if(std::memchr(characters, *begin, number_of_characters) != nullptr)
+				return begin;
+		}
+		return end;
+	}
+
+	const char* FindAnyOf(const char* begin, const char* end, const std::array<uint8_t, 256>& is_searched)
+	{
+		for(; end - begin >= 4; begin += 4)
+		{
+			if(is_searched[ static_cast<unsigned char>(begin[ 0 ]) ] | is_searched[ static_cast<unsigned char>(begin[ 1 ]) ] |
+			   is_searched[ static_cast<unsigned char>(begin[ 2 ]) ] | is_searched[ static_cast<unsigned char>(begin[ 3 ]) ])
+				break;
+		}
+		for(; begin != end && !is_searched[ static_cast<unsigned char>(*begin) ]; ++begin)
+		{
+		}
+		return begin;
+	}
+}
@@ -4,8 +4,18 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <set>
 #include <iterator>
+#include <functional>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <array>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace slarx
 {
@@ -24,6 +34,113 @@ namespace slarx
 		return result;
 	}
 
+	// Returns the index of the lowest set bit of x. x must not be 0
+	inline unsigned CountTrailingZeros(uint64_t x)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return index;
+#else
+		return __builtin_ctzll(x);
+#endif
+	}
+
+	// Calls f(i) for the index i of every set bit of a bitset stored in words 64-bit words
+	template<typename Function>
+	void ForEachSetBit(const uint64_t* bits, size_t words, Function f)
+	{
+		for(size_t w = 0; w < words; ++w)
+		{
+			for(uint64_t x = bits[ w ]; x != 0; x &= x - 1)
+			{
+				f(static_cast<uint32_t>(w * 64 + CountTrailingZeros(x)));
+			}
+		}
+	}
+
+	// Hashes a container of hashable elements (e.g. a set of states), so that it can be used as a key of an unordered container
+	struct ContainerHash
+	{
+		template<typename Container>
+		size_t operator()(const Container& container) const
+		{
+			size_t seed = container.size();
+			for(const auto& element : container)
+			{
+				seed ^= std::hash<typename Container::value_type>()(element) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			}
+			return seed;
+		}
+	};
+
+	// Calls f(begin, end) for the consecutive ranges of grain indices (the last one may be shorter), which cover [0, count).
+	// The ranges are handed out to number_of_threads threads (0 uses all hardware threads) as they finish their previous
+	// ranges. The calling thread is one of them
+	template<typename Function>
+	void ParallelFor(size_t count, size_t grain, unsigned number_of_threads, Function f)
+	{
+		if(number_of_threads == 0)
+		{
+			number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		const size_t number_of_ranges = (count + grain - 1) / grain;
+		number_of_threads = static_cast<unsigned>(std::min<size_t>(number_of_threads, number_of_ranges));
+		std::atomic<size_t> next_range(0);
+		auto worker = [&]()
+		{
+			for(size_t range = next_range++; range < number_of_ranges; range = next_range++)
+			{
+				f(range * grain, std::min(count, (range + 1) * grain));
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for(unsigned i = 1; i < number_of_threads; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	// FindAnyOf searches for at most this many characters at once
+	const unsigned kMaxSearchedCharacters = 3;
+	// Returns the first position in [begin, end), which holds one of number_of_characters (1 to kMaxSearchedCharacters) characters,
+	// or end if there is none. Uses memchr for a single character and compares 16 characters at a time with SSE2 otherwise
+	const char* FindAnyOf(const char* begin, const char* end, const char* characters, unsigned number_of_characters);
+	// Returns the first position in [begin, end), which holds a character c with is_searched[ c ] != 0, or end if there is none.
+	// The lookups do not depend on each other, so this is several times faster than following transitions of a DFA
+	const char* FindAnyOf(const char* begin, const char* end, const std::array<uint8_t, 256>& is_searched);
+
+	// Read-only memory mapping of a whole file. The mapping is released when the object is destroyed
+	class MappedFile
+	{
+	public:
+		// Maps the file located at path. Throws std::invalid_argument if the file can not be opened or mapped
+		explicit MappedFile(const std::string& path);
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		~MappedFile();
+
+		const char* GetData() const { return data_; }
+		size_t Size() const { return size_; }
+
+	private:
+		const char* data_;
+		size_t size_;
+#ifdef _WIN32
+		void* file_handle_;
+		void* mapping_handle_;
+#endif
+	};
+
+	// Splits [data, data + size) into lines, which end with "\n" or "\r\n". A final line without a line break is included too
+	std::vector<std::string_view> SplitLines(const char* data, size_t size);
+
 	// Utility function for reporting bugs. Should be used only for debug purposes
 	void Debug(const std::string& debug_message);
 }